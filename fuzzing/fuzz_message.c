@@ -9,6 +9,7 @@ int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
 
     print_config.expert_mode = true;
     print_config.signer_pubkey = NULL;
+    print_config.summary = NULL;
 
     if (parse_message_header(&parser, header)) {
         // This is not a valid Solana message
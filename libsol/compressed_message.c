@@ -0,0 +1,74 @@
+#include "common_byte_strings.h"
+#include "sol/compressed_message.h"
+#include "sol/parser.h"
+#include "util.h"
+#include <string.h>
+
+// The order is part of the upload encoding: new IDs may only be appended.
+// IDs are stored inline rather than as pointers so the table needs no
+// relocation
+static const Pubkey compression_dictionary[] = {
+    {{PROGRAM_ID_SYSTEM}},
+    {{PROGRAM_ID_STAKE}},
+    {{PROGRAM_ID_VOTE}},
+    {{PROGRAM_ID_SPL_TOKEN}},
+    {{PROGRAM_ID_SPL_ASSOCIATED_TOKEN_ACCOUNT}},
+    {{PROGRAM_ID_SPL_MEMO}},
+    {{SYSVAR_RENT}},
+    {{SYSVAR_CLOCK}},
+    {{SYSVAR_STAKE_HISTORY}},
+    {{SYSVAR_RECENT_BLOCKHASHES}},
+    {{SYSVAR_INSTRUCTIONS}},
+    {{STAKE_CONFIG_ID}},
+    {{PROGRAM_ID_COMPUTE_BUDGET}},
+};
+
+void compressed_message_decoder_init(CompressedMessageDecoder* decoder) {
+    decoder->literal_remaining = 0;
+}
+
+int compressed_message_expand(CompressedMessageDecoder* decoder,
+                              const uint8_t* in,
+                              size_t in_length,
+                              uint8_t* out,
+                              size_t out_size,
+                              size_t* out_length) {
+    size_t length = *out_length;
+    size_t i = 0;
+    while (i < in_length) {
+        if (decoder->literal_remaining > 0) {
+            size_t run = in_length - i;
+            if (run > decoder->literal_remaining) {
+                run = decoder->literal_remaining;
+            }
+            BAIL_IF(run > out_size - length);
+            memcpy(out + length, in + i, run);
+            length += run;
+            i += run;
+            decoder->literal_remaining -= run;
+            continue;
+        }
+
+        const uint8_t token = in[i++];
+        if (token < COMPRESSED_MESSAGE_REFERENCE) {
+            decoder->literal_remaining = token + 1;
+        } else {
+            const size_t entry = token - COMPRESSED_MESSAGE_REFERENCE;
+            BAIL_IF(entry >= ARRAY_LEN(compression_dictionary));
+            BAIL_IF(PUBKEY_SIZE > out_size - length);
+            memcpy(out + length, compression_dictionary[entry].data, PUBKEY_SIZE);
+            length += PUBKEY_SIZE;
+        }
+    }
+
+    *out_length = length;
+    return 0;
+}
+
+int compressed_message_finish(const CompressedMessageDecoder* decoder) {
+    return decoder->literal_remaining != 0;
+}
+
+size_t compressed_message_dictionary_length() {
+    return ARRAY_LEN(compression_dictionary);
+}
@@ -0,0 +1,152 @@
+#include "common_byte_strings.h"
+#include "compressed_message.c"
+#include "util.h"
+#include <assert.h>
+#include <stdio.h>
+
+// Reference encoder, as a host would implement it
+static size_t compress(const uint8_t* message, size_t length, uint8_t* out) {
+    size_t out_length = 0;
+    size_t literal_start = 0;
+    size_t i = 0;
+    while (i <= length) {
+        size_t entry = ARRAY_LEN(compression_dictionary);
+        if (i + PUBKEY_SIZE <= length) {
+            for (entry = 0; entry < ARRAY_LEN(compression_dictionary); entry++) {
+                if (memcmp(message + i, compression_dictionary[entry].data, PUBKEY_SIZE) == 0) {
+                    break;
+                }
+            }
+        }
+        if (entry < ARRAY_LEN(compression_dictionary) || i == length) {
+            while (literal_start < i) {
+                size_t run = i - literal_start;
+                if (run > COMPRESSED_MESSAGE_LITERAL_RUN_MAX) {
+                    run = COMPRESSED_MESSAGE_LITERAL_RUN_MAX;
+                }
+                out[out_length++] = run - 1;
+                memcpy(out + out_length, message + literal_start, run);
+                out_length += run;
+                literal_start += run;
+            }
+            if (i == length) {
+                break;
+            }
+            out[out_length++] = COMPRESSED_MESSAGE_REFERENCE + entry;
+            i += PUBKEY_SIZE;
+            literal_start = i;
+        } else {
+            i++;
+        }
+    }
+    return out_length;
+}
+
+void test_compressed_message_round_trip() {
+    // Stake delegation: stake, vote, clock, stake history, config IDs
+    uint8_t message[] = {
+        1, 0, 4,
+        BYTES32_BS58_1,
+        BYTES32_BS58_2,
+        BYTES32_BS58_3,
+        PROGRAM_ID_STAKE,
+        SYSVAR_CLOCK,
+        SYSVAR_STAKE_HISTORY,
+        STAKE_CONFIG_ID,
+        BYTES32_BS58_4,
+        1,
+        6, 6, 1, 2, 4, 5, 0, 3, 4, 2, 0, 0, 0
+    };
+    // Long enough literal runs to need several tokens
+    uint8_t long_message[300 + PUBKEY_SIZE];
+    for (size_t i = 0; i < 300; i++) {
+        long_message[i] = i;
+    }
+    const uint8_t memo[] = {PROGRAM_ID_SPL_MEMO};
+    memcpy(long_message + 300, memo, PUBKEY_SIZE);
+
+    const struct {
+        const uint8_t* message;
+        size_t length;
+    } cases[] = {{message, sizeof(message)}, {long_message, sizeof(long_message)}};
+
+    for (size_t c = 0; c < ARRAY_LEN(cases); c++) {
+        uint8_t compressed[512];
+        const size_t compressed_length = compress(cases[c].message, cases[c].length, compressed);
+        assert(compressed_length < cases[c].length);
+
+        // Every chunk size, so that literal runs and references are split
+        for (size_t chunk = 1; chunk <= compressed_length; chunk++) {
+            CompressedMessageDecoder decoder;
+            compressed_message_decoder_init(&decoder);
+            uint8_t expanded[512];
+            size_t expanded_length = 0;
+            for (size_t i = 0; i < compressed_length; i += chunk) {
+                size_t n = compressed_length - i;
+                if (n > chunk) {
+                    n = chunk;
+                }
+                assert(compressed_message_expand(&decoder,
+                                                 compressed + i,
+                                                 n,
+                                                 expanded,
+                                                 sizeof(expanded),
+                                                 &expanded_length) == 0);
+            }
+            assert(compressed_message_finish(&decoder) == 0);
+            assert(expanded_length == cases[c].length);
+            assert(memcmp(expanded, cases[c].message, expanded_length) == 0);
+        }
+    }
+}
+
+void test_compressed_message_dictionary() {
+    const uint8_t system[] = {PROGRAM_ID_SYSTEM};
+    const uint8_t compute_budget[] = {PROGRAM_ID_COMPUTE_BUDGET};
+    assert(compressed_message_dictionary_length() == 13);
+    assert_pubkey_equal(compression_dictionary[0].data, system);
+    assert_pubkey_equal(compression_dictionary[12].data, compute_budget);
+}
+
+void test_compressed_message_invalid() {
+    CompressedMessageDecoder decoder;
+    uint8_t out[PUBKEY_SIZE + 1];
+    size_t out_length;
+
+    // Unknown dictionary reference
+    const uint8_t unknown[] = {COMPRESSED_MESSAGE_REFERENCE + 13};
+    compressed_message_decoder_init(&decoder);
+    out_length = 0;
+    assert(compressed_message_expand(&decoder, unknown, 1, out, sizeof(out), &out_length) == 1);
+
+    // Truncated literal run
+    const uint8_t truncated[] = {2, 0xaa, 0xbb};
+    compressed_message_decoder_init(&decoder);
+    out_length = 0;
+    assert(compressed_message_expand(&decoder, truncated, 3, out, sizeof(out), &out_length) == 0);
+    assert(out_length == 2);
+    assert(compressed_message_finish(&decoder) == 1);
+
+    // Expansion past the output buffer
+    const uint8_t overflow[] = {0, 0xaa, COMPRESSED_MESSAGE_REFERENCE, 0, 0xbb};
+    compressed_message_decoder_init(&decoder);
+    out_length = 0;
+    assert(compressed_message_expand(&decoder, overflow, 3, out, sizeof(out), &out_length) == 0);
+    assert(out_length == sizeof(out));
+    assert(compressed_message_expand(&decoder, overflow + 3, 2, out, sizeof(out), &out_length) ==
+           1);
+
+    out_length = 2;
+    compressed_message_decoder_init(&decoder);
+    assert(compressed_message_expand(&decoder, overflow + 2, 1, out, sizeof(out), &out_length) ==
+           1);
+}
+
+int main() {
+    test_compressed_message_round_trip();
+    test_compressed_message_dictionary();
+    test_compressed_message_invalid();
+
+    printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compressed message upload
+//
+// A host may replace the well-known program and sysvar IDs of a message with
+// one-byte references into a fixed dictionary. The compressed stream is a
+// sequence of tokens:
+//
+//   0x00..0x7f  a literal run of (token + 1) bytes follows
+//   0x80..0xff  dictionary entry (token - 0x80), expands to its 32-byte ID
+//
+// The decoder keeps its state between calls, so a literal run may span
+// chunks. The expanded bytes are the exact original message.
+
+#define COMPRESSED_MESSAGE_LITERAL_RUN_MAX 0x80
+#define COMPRESSED_MESSAGE_REFERENCE       0x80
+
+typedef struct CompressedMessageDecoder {
+    // Bytes of the current literal run not received yet
+    uint8_t literal_remaining;
+} CompressedMessageDecoder;
+
+void compressed_message_decoder_init(CompressedMessageDecoder* decoder);
+
+// Expand `in` and append it to `out`, of which `*out_length` bytes are
+// already used. Fails on an unknown dictionary reference, or if the expanded
+// bytes don't fit `out_size`
+int compressed_message_expand(CompressedMessageDecoder* decoder,
+                              const uint8_t* in,
+                              size_t in_length,
+                              uint8_t* out,
+                              size_t out_size,
+                              size_t* out_length);
+
+// Fails if the stream stopped in the middle of a literal run
+int compressed_message_finish(const CompressedMessageDecoder* decoder);
+
+size_t compressed_message_dictionary_length();
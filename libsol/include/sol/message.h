@@ -6,3 +6,54 @@
 int process_message_body(const uint8_t* message_body,
                          int message_body_length,
                          const PrintConfig* print_config);
+
+// Streaming message processing
+//
+// The message stream sits behind a singleton and decodes a message while it
+// is still being uploaded. The caller appends every chunk to a buffer that
+// stays in place for the whole upload and then calls message_stream_update()
+// with the buffer and its new length. The header and each instruction are
+// decoded as soon as all of their bytes have arrived, so the summary is ready
+// to print once the last chunk lands.
+//
+// A message that can't be clear-signed is reported as soon as that is known,
+// usually well before the last chunk.
+//
+// Up to MAX_INSTRUCTIONS instructions are parsed, but no printer shows more
+// than MAX_DISPLAYED_INSTRUCTIONS of them, so a message with more displayed
+// instructions is rejected as soon as the extra one arrives. Memos and the
+// other ignored instructions don't count.
+//
+// The displayed instructions are only decoded when the message is printed,
+// into an arena lent by the caller for that time. MESSAGE_STREAM_ARENA_SIZE
+// holds all of them at full size; it needs InstructionInfo from
+// instruction.h.
+
+#define MESSAGE_STREAM_ARENA_SIZE (MAX_DISPLAYED_INSTRUCTIONS * sizeof(InstructionInfo))
+
+enum MessageStreamState {
+    MessageStreamHeader = 0,     // Waiting for the full message header
+    MessageStreamInstructions,   // Decoding instructions
+    MessageStreamTrailer,        // Waiting for the versioned message trailer
+    MessageStreamComplete,       // All instructions in and ready to print
+    MessageStreamUnrecognized,   // Valid header, body can only be blind signed
+    MessageStreamInvalid,        // Not a valid message
+};
+
+void message_stream_reset();
+enum MessageStreamState message_stream_update(const uint8_t* message,
+                                              size_t message_length,
+                                              bool last_chunk);
+enum MessageStreamState message_stream_state();
+
+// The parsed message header, NULL until it has been fully received
+const MessageHeader* message_stream_header();
+
+// Decode the displayed instructions of `message` into `arena`, which must be
+// aligned like uint64_t, and print them into the transaction summary. Fails
+// unless the stream is MessageStreamComplete
+int message_stream_print(const uint8_t* message,
+                         size_t message_length,
+                         uint8_t* arena,
+                         size_t arena_size,
+                         const PrintConfig* print_config);
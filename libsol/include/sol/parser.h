@@ -69,6 +69,77 @@ static inline int parser_is_empty(Parser* parser) {
     return parser->buffer_length == 0;
 }
 
+// Unchecked little-endian loads. Each compiles to a single (possibly
+// unaligned) load on little-endian targets. Callers are responsible for
+// having bounds-checked the bytes, normally through parse_record()
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+static inline uint16_t load_u16_le(const uint8_t* p) {
+    return (uint16_t) (p[0] | ((uint16_t) p[1] << 8));
+}
+
+static inline uint32_t load_u32_le(const uint8_t* p) {
+    return load_u16_le(p) | ((uint32_t) load_u16_le(p + 2) << 16);
+}
+
+static inline uint64_t load_u64_le(const uint8_t* p) {
+    return load_u32_le(p) | ((uint64_t) load_u32_le(p + 4) << 32);
+}
+#else
+static inline uint16_t load_u16_le(const uint8_t* p) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t load_u32_le(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t load_u64_le(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+#endif
+
+// A Record is a fixed-size run of fields that has been bounds-checked as a
+// whole by parse_record(). The record_* readers below then consume fields
+// without any further checks, so the sum of the field sizes read must not
+// exceed the size passed to parse_record()
+typedef struct Record {
+    const uint8_t* cursor;
+} Record;
+
+int parse_record(Parser* parser, size_t size, Record* record);
+
+static inline uint8_t record_u8(Record* record) {
+    return *record->cursor++;
+}
+
+static inline uint32_t record_u32(Record* record) {
+    uint32_t value = load_u32_le(record->cursor);
+    record->cursor += sizeof(value);
+    return value;
+}
+
+static inline uint64_t record_u64(Record* record) {
+    uint64_t value = load_u64_le(record->cursor);
+    record->cursor += sizeof(value);
+    return value;
+}
+
+static inline int64_t record_i64(Record* record) {
+    return (int64_t) record_u64(record);
+}
+
+static inline const Pubkey* record_pubkey(Record* record) {
+    const Pubkey* pubkey = (const Pubkey*) record->cursor;
+    record->cursor += PUBKEY_SIZE;
+    return pubkey;
+}
+
 int parse_u8(Parser* parser, uint8_t* value);
 
 int parse_u32(Parser* parser, uint32_t* value);
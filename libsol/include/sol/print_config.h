@@ -3,10 +3,14 @@
 #include "parser.h"
 #include <stdbool.h>
 
+struct TransactionSummaryContext;
+
 typedef struct PrintConfig {
     MessageHeader header;
     bool expert_mode;
     const Pubkey* signer_pubkey;
+    // Summary to print into, NULL selects the global one
+    struct TransactionSummaryContext* summary;
 } PrintConfig;
 
 bool print_config_show_authority(const PrintConfig* print_config, const Pubkey* authority);
@@ -5,8 +5,10 @@
 
 // TransactionSummary management
 //
-// TransactionSummary sits behind a singleton and is expected to be accessed
-// via the following methods
+// A TransactionSummary is owned by a TransactionSummaryContext, together with
+// the title and text buffers items are displayed into. The transaction_summary_
+// methods operate on a global context, the summary_context_ ones on the given
+// context, so that several messages can be summarized concurrently on the host
 //
 // A TransactionSummary consists of several SummaryItems.  If set previously,
 // they will be displayed in the following order:
@@ -19,7 +21,7 @@
 //
 // If all _Required_ `SummaryItem`s have not been set, finalization will fail.
 
-#define NUM_GENERAL_ITEMS 11
+#define NUM_GENERAL_ITEMS 26
 #define MAX_TRANSACTION_SUMMARY_ITEMS              \
     (1                       /* primary */         \
      + NUM_GENERAL_ITEMS + 1 /* nonce_account */   \
@@ -27,12 +29,6 @@
      + 1                     /* fee_payer */       \
     )
 
-typedef struct TokenAmount {
-    uint64_t value;
-    const char* symbol;
-    uint8_t decimals;
-} TokenAmount;
-
 enum SummaryItemKind {
     SummaryItemNone = 0,  // SummaryItemNone always zero
     SummaryItemAmount,
@@ -47,22 +43,191 @@ enum SummaryItemKind {
 };
 typedef enum SummaryItemKind SummaryItemKind_t;
 
-typedef struct SummaryItem SummaryItem;
+// Titles of the summary items. Items only keep the index of their title, the
+// strings are read back from a single constant array
+#define SUMMARY_TITLES(X)                     \
+    X(AdvanceNonce, "Advance nonce")          \
+    X(AllocateAcct, "Allocate acct")          \
+    X(Allowance, "Allowance")                 \
+    X(ApproveDelegate, "Approve delegate")    \
+    X(AssignAcct, "Assign acct")              \
+    X(Authority, "Authority")                 \
+    X(AuthorizedBy, "Authorized by")          \
+    X(Base, "Base")                           \
+    X(BurnTokens, "Burn tokens")              \
+    X(ClearAuthority, "Clear authority")      \
+    X(CloseAcct, "Close acct")                \
+    X(Commission, "Commission")               \
+    X(CreateAccount, "Create account")        \
+    X(CreateMultisig, "Create multisig")      \
+    X(CreateNonceAcct, "Create nonce acct")   \
+    X(CreateStakeAcct, "Create stake acct")   \
+    X(CreateTokenAcct, "Create token acct")   \
+    X(CreateTokenMint, "Create token mint")   \
+    X(CreateVoteAcct, "Create vote acct")     \
+    X(Custodian, "Custodian")                 \
+    X(DataSize, "Data size")                  \
+    X(DeactivateStake, "Deactivate stake")    \
+    X(Decimals, "Decimals")                   \
+    X(DelegateFrom, "Delegate from")          \
+    X(Deposit, "Deposit")                     \
+    X(Epoch, "Epoch")                         \
+    X(FeePayer, "Fee payer")                  \
+    X(Format, "Format")                       \
+    X(FreezeAcct, "Freeze acct")              \
+    X(FreezeAuthority, "Freeze authority")    \
+    X(From, "From")                           \
+    X(FromMint, "From mint")                  \
+    X(FundedBy, "Funded by")                  \
+    X(FundedWith, "Funded with")              \
+    X(Hash, "Hash")                           \
+    X(InitAcct, "Init acct")                  \
+    X(InitMint, "Init mint")                  \
+    X(InitMultisig, "Init multisig")          \
+    X(InitNonceAcct, "Init nonce acct")       \
+    X(InitStakeAcct, "Init stake acct")       \
+    X(InitVoteAcct, "Init vote acct")         \
+    X(Into, "Into")                           \
+    X(Lockup, "Lockup")                       \
+    X(LockupAuthority, "Lockup authority")    \
+    X(LockupEpoch, "Lockup epoch")            \
+    X(LockupTime, "Lockup time")              \
+    X(Merge, "Merge")                         \
+    X(MessageHash, "Message Hash")            \
+    X(Mint, "Mint")                           \
+    X(MintAuthority, "Mint authority")        \
+    X(MintDecimals, "Mint decimals")          \
+    X(MintTokens, "Mint tokens")              \
+    X(NewAuthorities, "New authorities")      \
+    X(NewAuthority, "New authority")          \
+    X(NewStakeAuth, "New stake auth")         \
+    X(NewValidatorID, "New validator ID")     \
+    X(NewVoteAuth, "New vote auth")           \
+    X(NewWithdrawAuth, "New withdraw auth")   \
+    X(NonceAccount, "Nonce account")          \
+    X(NonceAuthority, "Nonce authority")      \
+    X(NonceWithdraw, "Nonce withdraw")        \
+    X(OwnedBy, "Owned by")                    \
+    X(Owner, "Owner")                         \
+    X(Recipient, "Recipient")                 \
+    X(RequiredSigners, "Required signers")    \
+    X(RevokeDelegate, "Revoke delegate")      \
+    X(Seed, "Seed")                           \
+    X(Sender, "Sender")                       \
+    X(SetAuthority, "Set authority")          \
+    X(SetLockup, "Set lockup")                \
+    X(SetNonceAuth, "Set nonce auth")         \
+    X(SetStakeAuth, "Set stake auth")         \
+    X(SetVoteAuth, "Set vote auth")           \
+    X(Sign, "Sign")                           \
+    X(Signer, "Signer")                       \
+    X(Signers, "Signers")                     \
+    X(Size, "Size")                           \
+    X(SplitStake, "Split stake")              \
+    X(StakeWithdraw, "Stake withdraw")        \
+    X(SyncNativeAcct, "Sync native acct")     \
+    X(ThawAcct, "Thaw acct")                  \
+    X(Time, "Time")                           \
+    X(To, "To")                               \
+    X(ToProgram, "To program")                \
+    X(Transfer, "Transfer")                   \
+    X(TransferTokens, "Transfer tokens")      \
+    X(Type, "Type")                           \
+    X(Unrecognized, "Unrecognized")           \
+    X(UpdateCommission, "Update commission")  \
+    X(UpdateValidator, "Update validator")    \
+    X(ValidatorID, "Validator ID")            \
+    X(Version, "Version")                     \
+    X(VoteAccount, "Vote account")            \
+    X(VoteWithdraw, "Vote withdraw")          \
+    X(WithdrawTo, "Withdraw to")             
+
+enum SummaryTitle {
+    SummaryTitleNone = 0,
+#define SUMMARY_TITLE_ENUM(name, string) SummaryTitle##name,
+    SUMMARY_TITLES(SUMMARY_TITLE_ENUM)
+#undef SUMMARY_TITLE_ENUM
+};
+
+const char* summary_title_string(enum SummaryTitle title);
+
+// Packed to 12 bytes on the devices, against 24 with a title pointer and a
+// union of the value types, so twice as many items fit the same RAM. Values
+// are read back with the summary_item_ getters in transaction_summary.c
+typedef struct SummaryItem {
+    uint8_t kind;   // enum SummaryItemKind
+    uint8_t title;  // enum SummaryTitle
+    // Token amount decimals, and its token as get_token_index() of the mint
+    uint8_t decimals;
+    uint8_t token;
+    union {
+        // Amount, integer or timestamp, stored unaligned to keep the item
+        // word aligned
+        uint8_t value[sizeof(uint64_t)];
+        // Pubkey, Hash, string or sized string data
+        struct {
+            const void* ref;
+            // Sized string length, saturated at UINT16_MAX
+            uint16_t length;
+        };
+    };
+} SummaryItem;
+
+typedef struct TransactionSummary {
+    SummaryItem primary;
+    SummaryItem fee_payer;
+    SummaryItem nonce_account;
+    SummaryItem nonce_authority;
+    SummaryItem general[NUM_GENERAL_ITEMS];
+} TransactionSummary;
 
-extern char G_transaction_summary_title[TITLE_SIZE];
 #define TEXT_BUFFER_LENGTH BASE58_PUBKEY_LENGTH
-extern char G_transaction_summary_text[TEXT_BUFFER_LENGTH];
 
-void transaction_summary_reset();
+typedef struct TransactionSummaryContext {
+    TransactionSummary summary;
+    char title[TITLE_SIZE];
+    char text[TEXT_BUFFER_LENGTH];
+    // Display steps, built at finalize and valid below `step_count` until an
+    // item is set again. Each one is the position of its item in the display
+    // order of a full summary
+    size_t step_count;
+    uint8_t steps[MAX_TRANSACTION_SUMMARY_ITEMS];
+} TransactionSummaryContext;
+
+extern TransactionSummaryContext G_transaction_summary_context;
+#define G_transaction_summary_title (G_transaction_summary_context.title)
+#define G_transaction_summary_text  (G_transaction_summary_context.text)
+
 enum DisplayFlags {
     DisplayFlagNone = 0,
     DisplayFlagLongPubkeys = 1 << 0,
     DisplayFlagAll = DisplayFlagLongPubkeys,
 };
+
+// A NULL context selects G_transaction_summary_context. Items are rendered
+// each time they are displayed
+void summary_context_reset(TransactionSummaryContext* ctx);
+int summary_context_display_item(TransactionSummaryContext* ctx,
+                                 size_t item_index,
+                                 enum DisplayFlags flags);
+int summary_context_finalize(TransactionSummaryContext* ctx,
+                             enum SummaryItemKind* item_kinds,
+                             size_t* item_kinds_len);
+
+// Get a pointer to the requested SummaryItem. NULL if it has already been set
+SummaryItem* summary_context_primary_item(TransactionSummaryContext* ctx);
+SummaryItem* summary_context_fee_payer_item(TransactionSummaryContext* ctx);
+SummaryItem* summary_context_nonce_account_item(TransactionSummaryContext* ctx);
+SummaryItem* summary_context_nonce_authority_item(TransactionSummaryContext* ctx);
+SummaryItem* summary_context_general_item(TransactionSummaryContext* ctx);
+
+int summary_context_set_fee_payer_pubkey(TransactionSummaryContext* ctx, const Pubkey* pubkey);
+
+// The same, on the global context
+void transaction_summary_reset();
 int transaction_summary_display_item(size_t item_index, enum DisplayFlags flags);
 int transaction_summary_finalize(enum SummaryItemKind* item_kinds, size_t* item_kinds_len);
 
-// Get a pointer to the requested SummaryItem. NULL if it has already been set
 SummaryItem* transaction_summary_primary_item();
 SummaryItem* transaction_summary_fee_payer_item();
 SummaryItem* transaction_summary_nonce_account_item();
@@ -72,16 +237,18 @@ SummaryItem* transaction_summary_general_item();
 int transaction_summary_set_fee_payer_pubkey(const Pubkey* pubkey);
 
 // Assign type/title/value to a SummaryItem
-void summary_item_set_amount(SummaryItem* item, const char* title, uint64_t value);
+void summary_item_set_amount(SummaryItem* item, enum SummaryTitle title, uint64_t value);
 void summary_item_set_token_amount(SummaryItem* item,
-                                   const char* title,
+                                   enum SummaryTitle title,
                                    uint64_t value,
-                                   const char* symbol,
+                                   const Pubkey* mint,
                                    uint8_t decimals);
-void summary_item_set_i64(SummaryItem* item, const char* title, int64_t value);
-void summary_item_set_u64(SummaryItem* item, const char* title, uint64_t value);
-void summary_item_set_pubkey(SummaryItem* item, const char* title, const Pubkey* value);
-void summary_item_set_hash(SummaryItem* item, const char* title, const Hash* value);
-void summary_item_set_sized_string(SummaryItem* item, const char* title, const SizedString* value);
-void summary_item_set_string(SummaryItem* item, const char* title, const char* value);
-void summary_item_set_timestamp(SummaryItem* item, const char* title, int64_t value);
+void summary_item_set_i64(SummaryItem* item, enum SummaryTitle title, int64_t value);
+void summary_item_set_u64(SummaryItem* item, enum SummaryTitle title, uint64_t value);
+void summary_item_set_pubkey(SummaryItem* item, enum SummaryTitle title, const Pubkey* value);
+void summary_item_set_hash(SummaryItem* item, enum SummaryTitle title, const Hash* value);
+void summary_item_set_sized_string(SummaryItem* item,
+                                   enum SummaryTitle title,
+                                   const SizedString* value);
+void summary_item_set_string(SummaryItem* item, enum SummaryTitle title, const char* value);
+void summary_item_set_timestamp(SummaryItem* item, enum SummaryTitle title, int64_t value);
@@ -1,33 +1,71 @@
+#include "common_byte_strings.h"
 #include "instruction.h"
-#include "serum_assert_owner_instruction.h"
-#include "spl_memo_instruction.h"
-#include "spl_token_instruction.h"
-#include "stake_instruction.h"
-#include "system_instruction.h"
 #include "util.h"
 #include <string.h>
 
-enum ProgramId instruction_program_id(const Instruction* instruction, const MessageHeader* header) {
-    const Pubkey* program_id = &header->pubkeys[instruction->program_id_index];
-    if (memcmp(program_id, &system_program_id, PUBKEY_SIZE) == 0) {
-        return ProgramIdSystem;
-    } else if (memcmp(program_id, &stake_program_id, PUBKEY_SIZE) == 0) {
-        return ProgramIdStake;
-    } else if (memcmp(program_id, &vote_program_id, PUBKEY_SIZE) == 0) {
-        return ProgramIdVote;
-    } else if (memcmp(program_id, &spl_token_program_id, PUBKEY_SIZE) == 0) {
-        return ProgramIdSplToken;
-    } else if (memcmp(program_id, &spl_associated_token_account_program_id, PUBKEY_SIZE) == 0) {
-        return ProgramIdSplAssociatedTokenAccount;
-    } else if (is_serum_assert_owner_program_id(program_id)) {
-        return ProgramIdSerumAssertOwner;
-    } else if (memcmp(program_id, &spl_memo_program_id, PUBKEY_SIZE) == 0) {
-        return ProgramIdSplMemo;
-    }
+// First 8 bytes of a program ID byte string, as read by load_u64_le()
+#define PROGRAM_ID_PREFIX(...) PROGRAM_ID_PREFIX_(__VA_ARGS__)
+#define PROGRAM_ID_PREFIX_(b0, b1, b2, b3, b4, b5, b6, b7, ...)                              \
+    ((uint64_t) (b0) | (uint64_t) (b1) << 8 | (uint64_t) (b2) << 16 | (uint64_t) (b3) << 24 | \
+     (uint64_t) (b4) << 32 | (uint64_t) (b5) << 40 | (uint64_t) (b6) << 48 |                  \
+     (uint64_t) (b7) << 56)
+
+typedef struct KnownProgramId {
+    uint64_t prefix;
+    Pubkey program_id;
+    enum ProgramId kind;
+} KnownProgramId;
 
+#define KNOWN_PROGRAM_ID(program_id, kind) \
+    { PROGRAM_ID_PREFIX(program_id), {{program_id}}, kind }
+
+// IDs are stored inline rather than as pointers so the table needs no
+// relocation
+static const KnownProgramId known_program_ids[] = {
+    KNOWN_PROGRAM_ID(PROGRAM_ID_SYSTEM, ProgramIdSystem),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_STAKE, ProgramIdStake),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_VOTE, ProgramIdVote),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_SPL_TOKEN, ProgramIdSplToken),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_SPL_ASSOCIATED_TOKEN_ACCOUNT, ProgramIdSplAssociatedTokenAccount),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_SERUM_ASSERT_OWNER_PHANTOM, ProgramIdSerumAssertOwner),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_SERUM_ASSERT_OWNER, ProgramIdSerumAssertOwner),
+    KNOWN_PROGRAM_ID(PROGRAM_ID_SPL_MEMO, ProgramIdSplMemo),
+};
+
+// Only a matching prefix needs the full 32-byte compare
+enum ProgramId program_id_classify(const Pubkey* program_id) {
+    const uint64_t prefix = load_u64_le(program_id->data);
+    for (size_t i = 0; i < ARRAY_LEN(known_program_ids); i++) {
+        const KnownProgramId* known = &known_program_ids[i];
+        if (known->prefix == prefix && pubkeys_equal(program_id, &known->program_id)) {
+            return known->kind;
+        }
+    }
     return ProgramIdUnknown;
 }
 
+enum ProgramId instruction_program_id(const Instruction* instruction, const MessageHeader* header) {
+    return program_id_classify(&header->pubkeys[instruction->program_id_index]);
+}
+
+void program_id_table_init(ProgramIdTable* table) {
+    explicit_bzero(table, sizeof(ProgramIdTable));
+}
+
+enum ProgramId program_id_table_lookup(ProgramIdTable* table,
+                                       const Instruction* instruction,
+                                       const MessageHeader* header) {
+    const uint8_t index = instruction->program_id_index;
+    if (index >= PROGRAM_ID_TABLE_LENGTH) {
+        return instruction_program_id(instruction, header);
+    }
+    // Entries hold the program plus one, zero means not classified yet
+    if (table->program_ids[index] == 0) {
+        table->program_ids[index] = instruction_program_id(instruction, header) + 1;
+    }
+    return table->program_ids[index] - 1;
+}
+
 int instruction_validate(const Instruction* instruction, const MessageHeader* header) {
     BAIL_IF(instruction->program_id_index >= header->pubkeys_header.pubkeys_length);
     for (size_t i = 0; i < instruction->accounts_length; i++) {
@@ -36,40 +74,141 @@ int instruction_validate(const Instruction* instruction, const MessageHeader* he
     return 0;
 }
 
-bool instruction_info_matches_brief(const InstructionInfo* info, const InstructionBrief* brief) {
-    if (brief->program_id == info->kind) {
-        switch (brief->program_id) {
-            case ProgramIdSerumAssertOwner:
-                return true;
-            case ProgramIdSplAssociatedTokenAccount:
-                return true;
-            case ProgramIdSplMemo:
-                return true;
-            case ProgramIdSplToken:
-                return (brief->spl_token == info->spl_token.kind);
-            case ProgramIdStake:
-                return (brief->stake == info->stake.kind);
-            case ProgramIdSystem:
-                return (brief->system == info->system.kind);
-            case ProgramIdVote:
-                return (brief->vote == info->vote.kind);
-            case ProgramIdUnknown:
-                break;
-        }
+size_t instruction_info_size(const InstructionInfo* info) {
+    switch (info->kind) {
+        case ProgramIdSplAssociatedTokenAccount:
+            return MEMBER_END(InstructionInfo, spl_associated_token_account);
+        case ProgramIdSplToken:
+            return offsetof(InstructionInfo, spl_token) + spl_token_info_size(&info->spl_token);
+        case ProgramIdStake:
+            return offsetof(InstructionInfo, stake) + stake_info_size(&info->stake);
+        case ProgramIdSystem:
+            return offsetof(InstructionInfo, system) + system_info_size(&info->system);
+        case ProgramIdVote:
+            return offsetof(InstructionInfo, vote) + vote_info_size(&info->vote);
+        case ProgramIdSerumAssertOwner:
+        case ProgramIdSplMemo:
+        case ProgramIdUnknown:
+            break;
+    }
+    return MEMBER_END(InstructionInfo, kind);
+}
+
+void instruction_pool_init(InstructionPool* pool, uint8_t* buffer, size_t buffer_size) {
+    explicit_bzero(pool, sizeof(InstructionPool));
+    explicit_bzero(buffer, buffer_size);
+    pool->buffer = buffer;
+    pool->buffer_size = buffer_size;
+}
+
+InstructionInfo* instruction_pool_push(InstructionPool* pool, const InstructionInfo* info) {
+    // Keep every record aligned like a full InstructionInfo
+    const size_t align = _Alignof(InstructionInfo);
+    const size_t offset = (pool->used + align - 1) & ~(align - 1);
+    const size_t size = instruction_info_size(info);
+
+    if (pool->count == MAX_DISPLAYED_INSTRUCTIONS || offset > pool->buffer_size ||
+        size > pool->buffer_size - offset) {
+        return NULL;
     }
-    return false;
+
+    InstructionInfo* record = (void*) (pool->buffer + offset);
+    memcpy(record, info, size);
+    pool->used = offset + size;
+    pool->infos[pool->count++] = record;
+    return record;
 }
 
-bool instruction_infos_match_briefs(InstructionInfo* const* infos,
-                                    const InstructionBrief* briefs,
-                                    size_t len) {
-    size_t i;
-    for (i = 0; i < len; i++) {
-        if (!instruction_info_matches_brief(infos[i], &briefs[i])) {
+_Static_assert(ProgramIdSerumAssertOwner < (1 << (8 - INSTRUCTION_KIND_BITS)),
+               "ProgramId does not fit an instruction code");
+_Static_assert(SplTokenKind(SyncNative) < (1 << INSTRUCTION_KIND_BITS),
+               "SPL token instruction kind does not fit an instruction code");
+_Static_assert(StakeSetLockupChecked < (1 << INSTRUCTION_KIND_BITS),
+               "Stake instruction kind does not fit an instruction code");
+_Static_assert(SystemAssignWithSeed < (1 << INSTRUCTION_KIND_BITS),
+               "System instruction kind does not fit an instruction code");
+_Static_assert(VoteAuthorizeChecked < (1 << INSTRUCTION_KIND_BITS),
+               "Vote instruction kind does not fit an instruction code");
+
+uint8_t instruction_info_code(const InstructionInfo* info) {
+    switch (info->kind) {
+        case ProgramIdSplToken:
+            return INSTRUCTION_CODE(info->kind, info->spl_token.kind);
+        case ProgramIdStake:
+            return INSTRUCTION_CODE(info->kind, info->stake.kind);
+        case ProgramIdSystem:
+            return INSTRUCTION_CODE(info->kind, info->system.kind);
+        case ProgramIdVote:
+            return INSTRUCTION_CODE(info->kind, info->vote.kind);
+        case ProgramIdSplAssociatedTokenAccount:
+        case ProgramIdSerumAssertOwner:
+        case ProgramIdSplMemo:
+        case ProgramIdUnknown:
             break;
+    }
+    return INSTRUCTION_CODE(info->kind, 0);
+}
+
+int instruction_peek_code(const Instruction* instruction,
+                          enum ProgramId program_id,
+                          uint8_t* code) {
+    Parser parser = {instruction->data, instruction->data_length};
+    switch (program_id) {
+        case ProgramIdSplToken: {
+            SplTokenInstructionKind kind;
+            BAIL_IF(parse_spl_token_instruction_kind(&parser, &kind));
+            *code = INSTRUCTION_CODE(program_id, kind);
+            return 0;
+        }
+        case ProgramIdStake: {
+            enum StakeInstructionKind kind;
+            BAIL_IF(parse_stake_instruction_kind(&parser, &kind));
+            *code = INSTRUCTION_CODE(program_id, kind);
+            return 0;
+        }
+        case ProgramIdSystem: {
+            enum SystemInstructionKind kind;
+            BAIL_IF(parse_system_instruction_kind(&parser, &kind));
+            *code = INSTRUCTION_CODE(program_id, kind);
+            return 0;
         }
+        case ProgramIdVote: {
+            enum VoteInstructionKind kind;
+            BAIL_IF(parse_vote_instruction_kind(&parser, &kind));
+            *code = INSTRUCTION_CODE(program_id, kind);
+            return 0;
+        }
+        case ProgramIdSplAssociatedTokenAccount:
+        case ProgramIdSerumAssertOwner:
+        case ProgramIdSplMemo:
+            *code = INSTRUCTION_CODE(program_id, 0);
+            return 0;
+        case ProgramIdUnknown:
+            break;
+    }
+    return 1;
+}
+
+uint32_t instruction_codes_signature(const uint8_t* codes, size_t codes_length) {
+    if (codes_length > MAX_SIGNATURE_INSTRUCTIONS) {
+        return 0;
+    }
+    uint32_t signature = 0;
+    for (size_t i = 0; i < codes_length; i++) {
+        signature |= (uint32_t) codes[i] << (8 * i);
+    }
+    return signature;
+}
+
+uint32_t instruction_infos_signature(InstructionInfo* const* infos, size_t infos_length) {
+    if (infos_length > MAX_SIGNATURE_INSTRUCTIONS) {
+        return 0;
+    }
+    uint32_t signature = 0;
+    for (size_t i = 0; i < infos_length; i++) {
+        signature |= (uint32_t) instruction_info_code(infos[i]) << (8 * i);
     }
-    return (i == len);
+    return signature;
 }
 
 void instruction_accounts_iterator_init(InstructionAccountsIterator* it,
@@ -8,6 +8,13 @@
 #include "vote_instruction.h"
 #include <stdbool.h>
 
+// Instructions of a message that can be parsed. Ignored instructions such as
+// memos count towards it, while the displayed ones must still match a printer
+#define MAX_INSTRUCTIONS 20
+// Displayed instructions of a printable message: a nonce advance and the
+// longest transaction pattern
+#define MAX_DISPLAYED_INSTRUCTIONS 4
+
 enum ProgramId {
     ProgramIdUnknown = 0,
     ProgramIdStake,
@@ -30,35 +37,62 @@ typedef struct InstructionInfo {
     };
 } InstructionInfo;
 
+// Bytes of `info` used by its instruction kind, i.e. without the unused tail
+// of the info unions
+size_t instruction_info_size(const InstructionInfo* info);
+
+// Bump arena of decoded instructions. Each record only takes the bytes its
+// instruction kind needs, so the same RAM holds many more instructions than
+// an array of full InstructionInfo
+typedef struct InstructionPool {
+    uint8_t* buffer;
+    size_t buffer_size;
+    size_t used;
+    size_t count;
+    InstructionInfo* infos[MAX_DISPLAYED_INSTRUCTIONS];
+} InstructionPool;
+
+void instruction_pool_init(InstructionPool* pool, uint8_t* buffer, size_t buffer_size);
+// Copy `info` into a new record. Returns NULL if the pool is full
+InstructionInfo* instruction_pool_push(InstructionPool* pool, const InstructionInfo* info);
+
+enum ProgramId program_id_classify(const Pubkey* program_id);
 enum ProgramId instruction_program_id(const Instruction* instruction, const MessageHeader* header);
+
+// Program of each account key of a message, indexed like the keys. A key is
+// classified the first time an instruction uses it as program ID, so
+// instructions sharing a program resolve it with a single lookup. Keys past
+// the end of the table are classified on every use
+#define PROGRAM_ID_TABLE_LENGTH 64
+
+typedef struct ProgramIdTable {
+    uint8_t program_ids[PROGRAM_ID_TABLE_LENGTH];
+} ProgramIdTable;
+
+void program_id_table_init(ProgramIdTable* table);
+enum ProgramId program_id_table_lookup(ProgramIdTable* table,
+                                       const Instruction* instruction,
+                                       const MessageHeader* header);
 int instruction_validate(const Instruction* instruction, const MessageHeader* header);
 
-typedef struct InstructionBrief {
-    enum ProgramId program_id;
-    union {
-        int none;
-        SplTokenInstructionKind spl_token;
-        enum SystemInstructionKind system;
-        enum StakeInstructionKind stake;
-        enum VoteInstructionKind vote;
-    };
-} InstructionBrief;
-
-#define SPL_ASSOCIATED_TOKEN_ACCOUNT_IX_BRIEF \
-    { ProgramIdSplAssociatedTokenAccount, .none = 0 }
-#define SPL_TOKEN_IX_BRIEF(spl_token_ix) \
-    { ProgramIdSplToken, .spl_token = (spl_token_ix) }
-#define SYSTEM_IX_BRIEF(system_ix) \
-    { ProgramIdSystem, .system = (system_ix) }
-#define STAKE_IX_BRIEF(stake_ix) \
-    { ProgramIdStake, .stake = (stake_ix) }
-#define VOTE_IX_BRIEF(vote_ix) \
-    { ProgramIdVote, .vote = (vote_ix) }
-
-bool instruction_info_matches_brief(const InstructionInfo* info, const InstructionBrief* brief);
-bool instruction_infos_match_briefs(InstructionInfo* const* infos,
-                                    const InstructionBrief* briefs,
-                                    size_t len);
+// (program, kind) of an instruction packed in a byte. Known programs are
+// never ProgramIdUnknown, so a code is never zero
+#define INSTRUCTION_KIND_BITS 5
+#define INSTRUCTION_CODE(program_id, kind) \
+    ((uint8_t) (((program_id) << INSTRUCTION_KIND_BITS) | (kind)))
+
+// Codes of up to four instructions packed in message order, first in the
+// low byte. Zero if there are more instructions than fit
+#define MAX_SIGNATURE_INSTRUCTIONS 4
+
+uint8_t instruction_info_code(const InstructionInfo* info);
+// Read the code of an instruction of program `program_id` from its kind tag
+// alone, without decoding the rest of it
+int instruction_peek_code(const Instruction* instruction,
+                          enum ProgramId program_id,
+                          uint8_t* code);
+uint32_t instruction_codes_signature(const uint8_t* codes, size_t codes_length);
+uint32_t instruction_infos_signature(InstructionInfo* const* infos, size_t infos_length);
 
 typedef struct InstructionAccountsIterator {
     const Pubkey* message_header_pubkeys;
@@ -101,62 +101,32 @@ void test_instruction_validate_bad_last_account_index_fail() {
     }
 }
 
-void test_static_brief_initializer_macros() {
-    InstructionBrief system_test = SYSTEM_IX_BRIEF(SystemTransfer);
-    InstructionBrief system_expect = {ProgramIdSystem, .system = SystemTransfer};
-    assert(memcmp(&system_test, &system_expect, sizeof(InstructionBrief)) == 0);
-    InstructionBrief stake_test = STAKE_IX_BRIEF(StakeDelegate);
-    InstructionBrief stake_expect = {ProgramIdStake, .stake = StakeDelegate};
-    assert(memcmp(&stake_test, &stake_expect, sizeof(InstructionBrief)) == 0);
-}
-
-void test_instruction_info_matches_brief() {
-    InstructionInfo info = {
-        .kind = ProgramIdSystem,
-        .system =
-            {
-                .kind = SystemTransfer,
-                .transfer = {NULL, NULL, 0},
-            },
+void test_instruction_infos_signature() {
+    InstructionInfo infos[] = {
+        {.kind = ProgramIdSystem, .system = {.kind = SystemCreateAccount}},
+        {.kind = ProgramIdStake, .stake = {.kind = StakeInitialize}},
+        {.kind = ProgramIdSplAssociatedTokenAccount},
     };
-    InstructionBrief brief_pass = SYSTEM_IX_BRIEF(SystemTransfer);
-    assert(instruction_info_matches_brief(&info, &brief_pass));
-    InstructionBrief brief_fail = SYSTEM_IX_BRIEF(SystemAdvanceNonceAccount);
-    assert(!instruction_info_matches_brief(&info, &brief_fail));
-}
+    InstructionInfo* display_infos[] = {&infos[0], &infos[1], &infos[2], &infos[0], &infos[1]};
 
-void test_instruction_infos_match_briefs() {
-    InstructionInfo infos[] = {{
-                                   .kind = ProgramIdSystem,
-                                   .system =
-                                       {
-                                           .kind = SystemTransfer,
-                                           .transfer = {NULL, NULL, 0},
-                                       },
-                               },
-                               {
-                                   .kind = ProgramIdStake,
-                                   .stake =
-                                       {
-                                           .kind = StakeDelegate,
-                                           .delegate_stake = {NULL, NULL, NULL},
-                                       },
-                               }};
-    InstructionBrief briefs[] = {
-        SYSTEM_IX_BRIEF(SystemTransfer),
-        STAKE_IX_BRIEF(StakeDelegate),
-    };
-    InstructionBrief bad_briefs[] = {
-        SYSTEM_IX_BRIEF(SystemTransfer),
-        STAKE_IX_BRIEF(StakeSplit),
-    };
-    InstructionInfo* display_infos[] = {&infos[0], &infos[1]};
-    size_t infos_len = ARRAY_LEN(infos);
-    assert(infos_len == ARRAY_LEN(display_infos));
-    assert(infos_len == ARRAY_LEN(briefs));
-    assert(infos_len == ARRAY_LEN(bad_briefs));
-    assert(instruction_infos_match_briefs(display_infos, briefs, infos_len));
-    assert(!instruction_infos_match_briefs(display_infos, bad_briefs, infos_len));
+    assert(instruction_info_code(&infos[0]) ==
+           INSTRUCTION_CODE(ProgramIdSystem, SystemCreateAccount));
+    assert(instruction_info_code(&infos[2]) ==
+           INSTRUCTION_CODE(ProgramIdSplAssociatedTokenAccount, 0));
+    assert(instruction_info_code(&infos[2]) != 0);
+
+    assert(instruction_infos_signature(display_infos, 0) == 0);
+    assert(instruction_infos_signature(display_infos, 2) ==
+           ((uint32_t) INSTRUCTION_CODE(ProgramIdSystem, SystemCreateAccount) |
+            (uint32_t) INSTRUCTION_CODE(ProgramIdStake, StakeInitialize) << 8));
+    // Same instructions in another order
+    assert(instruction_infos_signature(display_infos, 2) !=
+           instruction_infos_signature(&display_infos[1], 2));
+    // A prefix never collides with the longer message
+    assert(instruction_infos_signature(display_infos, 2) !=
+           instruction_infos_signature(display_infos, 3));
+    assert(instruction_infos_signature(display_infos, MAX_SIGNATURE_INSTRUCTIONS) != 0);
+    assert(instruction_infos_signature(display_infos, MAX_SIGNATURE_INSTRUCTIONS + 1) == 0);
 }
 
 void test_instruction_accounts_iterator_next() {
@@ -206,6 +176,97 @@ void test_instruction_accounts_iterator_next() {
     assert(instruction_accounts_iterator_remaining(&it) == expected_remaining);
 }
 
+void test_program_id_classify() {
+    const Pubkey system = {{PROGRAM_ID_SYSTEM}};
+    const Pubkey stake = {{PROGRAM_ID_STAKE}};
+    const Pubkey vote = {{PROGRAM_ID_VOTE}};
+    const Pubkey spl_token = {{PROGRAM_ID_SPL_TOKEN}};
+    const Pubkey spl_ata = {{PROGRAM_ID_SPL_ASSOCIATED_TOKEN_ACCOUNT}};
+    const Pubkey serum = {{PROGRAM_ID_SERUM_ASSERT_OWNER}};
+    const Pubkey serum_phantom = {{PROGRAM_ID_SERUM_ASSERT_OWNER_PHANTOM}};
+    const Pubkey spl_memo = {{PROGRAM_ID_SPL_MEMO}};
+    assert(program_id_classify(&system) == ProgramIdSystem);
+    assert(program_id_classify(&stake) == ProgramIdStake);
+    assert(program_id_classify(&vote) == ProgramIdVote);
+    assert(program_id_classify(&spl_token) == ProgramIdSplToken);
+    assert(program_id_classify(&spl_ata) == ProgramIdSplAssociatedTokenAccount);
+    assert(program_id_classify(&serum) == ProgramIdSerumAssertOwner);
+    assert(program_id_classify(&serum_phantom) == ProgramIdSerumAssertOwner);
+    assert(program_id_classify(&spl_memo) == ProgramIdSplMemo);
+
+    // Same prefix as a known program is not enough
+    Pubkey lookalike = stake;
+    lookalike.data[PUBKEY_SIZE - 1] ^= 1;
+    assert(program_id_classify(&lookalike) == ProgramIdUnknown);
+    Pubkey sysvar_rent = {{SYSVAR_RENT}};
+    assert(program_id_classify(&sysvar_rent) == ProgramIdUnknown);
+}
+
+void test_program_id_table_lookup() {
+    Pubkey pubkeys[] = {{{BYTES32_BS58_2}}, {{PROGRAM_ID_STAKE}}, {{PROGRAM_ID_SYSTEM}}};
+    MessageHeader header = {false, 0, {1, 0, 2, ARRAY_LEN(pubkeys)}, pubkeys, NULL, 3};
+    Instruction stake_ix = {1, NULL, 0, NULL, 0};
+    Instruction system_ix = {2, NULL, 0, NULL, 0};
+
+    ProgramIdTable table;
+    program_id_table_init(&table);
+    assert(program_id_table_lookup(&table, &stake_ix, &header) == ProgramIdStake);
+    assert(program_id_table_lookup(&table, &system_ix, &header) == ProgramIdSystem);
+
+    // Resolved from the table without looking at the key again
+    memset(&pubkeys[1], 0xff, PUBKEY_SIZE);
+    assert(program_id_table_lookup(&table, &stake_ix, &header) == ProgramIdStake);
+
+    program_id_table_init(&table);
+    assert(program_id_table_lookup(&table, &stake_ix, &header) == ProgramIdUnknown);
+}
+
+void test_instruction_info_size() {
+    InstructionInfo info = {.kind = ProgramIdSystem, .system = {.kind = SystemTransfer}};
+    assert(instruction_info_size(&info) < sizeof(InstructionInfo));
+
+    info.kind = ProgramIdSplMemo;
+    assert(instruction_info_size(&info) == sizeof(enum ProgramId));
+}
+
+void test_instruction_pool_push() {
+    _Alignas(InstructionInfo) uint8_t buffer[2 * sizeof(InstructionInfo)];
+    InstructionPool pool;
+    instruction_pool_init(&pool, buffer, sizeof(buffer));
+
+    Pubkey from = {{1}};
+    InstructionInfo transfer = {
+        .kind = ProgramIdSystem,
+        .system = {.kind = SystemTransfer, .transfer = {&from, &from, 42}},
+    };
+    InstructionInfo token_transfer = {
+        .kind = ProgramIdSplToken,
+        .spl_token = {.kind = SplTokenKind(TransferChecked)},
+    };
+
+    // Small records pack more instructions than full InstructionInfo would fit
+    size_t count = 0;
+    while (instruction_pool_push(&pool, &transfer) != NULL) {
+        count++;
+    }
+    assert(count > 2);
+    assert(pool.count == count);
+    for (size_t i = 0; i < count; i++) {
+        assert(pool.infos[i]->kind == ProgramIdSystem);
+        assert(pool.infos[i]->system.kind == SystemTransfer);
+        assert(pool.infos[i]->system.transfer.from == &from);
+        assert(pool.infos[i]->system.transfer.lamports == 42);
+        assert((uintptr_t) pool.infos[i] % _Alignof(InstructionInfo) == 0);
+    }
+
+    // A larger record no longer fits
+    instruction_pool_init(&pool, buffer, sizeof(buffer));
+    assert(instruction_pool_push(&pool, &token_transfer) != NULL);
+    assert(instruction_pool_push(&pool, &token_transfer) != NULL);
+    assert(instruction_pool_push(&pool, &token_transfer) == NULL);
+    assert(pool.count == 2);
+}
+
 int main() {
     test_instruction_validate_ok();
     test_instruction_validate_bad_program_id_index_fail();
@@ -214,10 +275,12 @@ int main() {
     test_instruction_program_id_unknown();
     test_instruction_program_id_stake();
     test_instruction_program_id_system();
-    test_static_brief_initializer_macros();
-    test_instruction_info_matches_brief();
-    test_instruction_infos_match_briefs();
+    test_instruction_infos_signature();
     test_instruction_accounts_iterator_next();
+    test_program_id_classify();
+    test_program_id_table_lookup();
+    test_instruction_info_size();
+    test_instruction_pool_push();
 
     printf("passed\n");
     return 0;
@@ -12,106 +12,320 @@
 #include "util.h"
 #include <string.h>
 
-#define MAX_INSTRUCTIONS 4
+// Decode an instruction of program `program_id` into `info`. `info->kind` is
+// left as ProgramIdUnknown if the program or instruction is not supported
+static void instruction_info_decode(const Instruction* instruction,
+                                    const MessageHeader* header,
+                                    enum ProgramId program_id,
+                                    InstructionInfo* info) {
+    switch (program_id) {
+        case ProgramIdSerumAssertOwner: {
+            // Serum assert-owner only has one instruction and we ignore it
+            info->kind = program_id;
+            break;
+        }
+        case ProgramIdSplAssociatedTokenAccount: {
+            if (parse_spl_associated_token_account_instructions(
+                    instruction,
+                    header,
+                    &info->spl_associated_token_account) == 0) {
+                info->kind = program_id;
+            }
+            break;
+        }
+        case ProgramIdSplMemo: {
+            // SPL Memo only has one instruction and we ignore it for now
+            info->kind = program_id;
+            break;
+        }
+        case ProgramIdSplToken:
+            if (parse_spl_token_instructions(instruction, header, &info->spl_token) == 0) {
+                info->kind = program_id;
+            }
+            break;
+        case ProgramIdSystem: {
+            if (parse_system_instructions(instruction, header, &info->system) == 0) {
+                info->kind = program_id;
+            }
+            break;
+        }
+        case ProgramIdStake: {
+            if (parse_stake_instructions(instruction, header, &info->stake) == 0) {
+                info->kind = program_id;
+            }
+            break;
+        }
+        case ProgramIdVote: {
+            if (parse_vote_instructions(instruction, header, &info->vote) == 0) {
+                info->kind = program_id;
+            }
+            break;
+        }
+        case ProgramIdUnknown:
+            break;
+    }
+}
 
-int process_message_body(const uint8_t* message_body,
-                         int message_body_length,
-                         const PrintConfig* print_config) {
-    const MessageHeader* header = &print_config->header;
+static bool program_id_is_displayed(enum ProgramId program_id) {
+    switch (program_id) {
+        case ProgramIdSplAssociatedTokenAccount:
+        case ProgramIdSplToken:
+        case ProgramIdSystem:
+        case ProgramIdStake:
+        case ProgramIdVote:
+        case ProgramIdUnknown:
+            return true;
+        // Ignored instructions
+        case ProgramIdSerumAssertOwner:
+        case ProgramIdSplMemo:
+            break;
+    }
+    return false;
+}
+
+typedef struct MessageStream {
+    enum MessageStreamState state;
+    MessageHeader header;
+    // Bytes of the message consumed by the header and decoded instructions
+    size_t offset;
+    size_t instruction_count;
+    ProgramIdTable program_ids;
+    // Codes and offsets of the displayed instructions, read as they arrive.
+    // They are decoded only once the whole message is known to be printable
+    size_t display_count;
+    uint8_t display_codes[MAX_DISPLAYED_INSTRUCTIONS];
+    uint16_t display_offsets[MAX_DISPLAYED_INSTRUCTIONS];
+    // Decoded displayed instructions, in message order. Filled in the arena
+    // of the caller while the message is printed
+    InstructionPool pool;
+} MessageStream;
 
-    BAIL_IF(header->instructions_length == 0);
-    BAIL_IF(header->instructions_length > MAX_INSTRUCTIONS);
+static MessageStream G_message_stream;
 
-    size_t instruction_count = 0;
-    InstructionInfo instruction_info[MAX_INSTRUCTIONS];
-    explicit_bzero(instruction_info, sizeof(InstructionInfo) * MAX_INSTRUCTIONS);
+static void message_stream_init(MessageStream* stream) {
+    explicit_bzero(stream, sizeof(MessageStream));
+}
+
+void message_stream_reset() {
+    message_stream_init(&G_message_stream);
+}
+
+// A short read on a partial message only means we have to wait for the next
+// chunk. Once the last chunk is in, it is final
+static enum MessageStreamState message_stream_short_read(MessageStream* stream,
+                                                         bool last_chunk,
+                                                         enum MessageStreamState failed_state) {
+    if (last_chunk) {
+        stream->state = failed_state;
+    }
+    return stream->state;
+}
+
+static void message_stream_advance(MessageStream* stream, const uint8_t* message, Parser* parser) {
+    stream->offset = parser->buffer - message;
+}
+
+static void message_stream_begin_body(MessageStream* stream) {
+    const MessageHeader* header = &stream->header;
+    if (header->instructions_length == 0 || header->instructions_length > MAX_INSTRUCTIONS) {
+        stream->state = MessageStreamUnrecognized;
+    } else {
+        program_id_table_init(&stream->program_ids);
+        stream->state = MessageStreamInstructions;
+    }
+}
+
+// Once all instructions are in, pick the printer from the instruction codes.
+// The displayed instructions are only fully decoded when printed
+static enum MessageStreamState message_stream_select_printer(const MessageStream* stream) {
+    if (!transaction_is_printable(stream->display_codes, stream->display_count)) {
+        return MessageStreamUnrecognized;
+    }
+    return MessageStreamComplete;
+}
 
-    size_t display_instruction_count = 0;
-    InstructionInfo* display_instruction_info[MAX_INSTRUCTIONS];
+static int message_stream_decode_displayed(MessageStream* stream,
+                                           const uint8_t* message,
+                                           size_t message_length,
+                                           uint8_t* arena,
+                                           size_t arena_size) {
+    const MessageHeader* header = &stream->header;
 
-    Parser parser = {message_body, message_body_length};
-    for (; instruction_count < header->instructions_length; instruction_count++) {
+    BAIL_IF((uintptr_t) arena % _Alignof(InstructionInfo) != 0);
+    instruction_pool_init(&stream->pool, arena, arena_size);
+    for (size_t i = 0; i < stream->display_count; i++) {
+        const size_t offset = stream->display_offsets[i];
+        Parser parser = {message + offset, message_length - offset};
         Instruction instruction;
+        InstructionInfo info;
+        explicit_bzero(&info, sizeof(InstructionInfo));
         BAIL_IF(parse_instruction(&parser, &instruction));
-        BAIL_IF(instruction_validate(&instruction, header));
+        instruction_info_decode(&instruction,
+                                header,
+                                program_id_table_lookup(&stream->program_ids, &instruction, header),
+                                &info);
+        BAIL_IF(info.kind == ProgramIdUnknown);
+        BAIL_IF(instruction_pool_push(&stream->pool, &info) == NULL);
+    }
+    return 0;
+}
 
-        InstructionInfo* info = &instruction_info[instruction_count];
-        enum ProgramId program_id = instruction_program_id(&instruction, header);
-        switch (program_id) {
-            case ProgramIdSerumAssertOwner: {
-                // Serum assert-owner only has one instruction and we ignore it
-                info->kind = program_id;
-                break;
-            }
-            case ProgramIdSplAssociatedTokenAccount: {
-                if (parse_spl_associated_token_account_instructions(
-                        &instruction,
-                        header,
-                        &info->spl_associated_token_account) == 0) {
-                    info->kind = program_id;
+static enum MessageStreamState message_stream_decode(MessageStream* stream,
+                                                     const uint8_t* message,
+                                                     size_t message_length,
+                                                     bool last_chunk) {
+    const MessageHeader* header = &stream->header;
+
+    for (;;) {
+        Parser parser = {message + stream->offset, message_length - stream->offset};
+        switch (stream->state) {
+            case MessageStreamHeader:
+                if (parse_message_header(&parser, &stream->header) != 0) {
+                    return message_stream_short_read(stream, last_chunk, MessageStreamInvalid);
                 }
+                message_stream_advance(stream, message, &parser);
+                message_stream_begin_body(stream);
                 break;
-            }
-            case ProgramIdSplMemo: {
-                // SPL Memo only has one instruction and we ignore it for now
-                info->kind = program_id;
-                break;
-            }
-            case ProgramIdSplToken:
-                if (parse_spl_token_instructions(&instruction, header, &info->spl_token) == 0) {
-                    info->kind = program_id;
+            case MessageStreamInstructions: {
+                Instruction instruction;
+                if (parse_instruction(&parser, &instruction) != 0) {
+                    return message_stream_short_read(stream,
+                                                     last_chunk,
+                                                     MessageStreamUnrecognized);
                 }
-                break;
-            case ProgramIdSystem: {
-                if (parse_system_instructions(&instruction, header, &info->system) == 0) {
-                    info->kind = program_id;
+                // The instruction is complete, so anything wrong with it is final.
+                // Only its program and kind tag are read for now
+                if (instruction_validate(&instruction, header) != 0) {
+                    stream->state = MessageStreamUnrecognized;
+                    break;
                 }
-                break;
-            }
-            case ProgramIdStake: {
-                if (parse_stake_instructions(&instruction, header, &info->stake) == 0) {
-                    info->kind = program_id;
+                enum ProgramId program_id =
+                    program_id_table_lookup(&stream->program_ids, &instruction, header);
+                uint8_t code;
+                if (program_id == ProgramIdUnknown ||
+                    instruction_peek_code(&instruction, program_id, &code) != 0) {
+                    stream->state = MessageStreamUnrecognized;
+                    break;
+                }
+                if (program_id_is_displayed(program_id)) {
+                    // No printer takes more displayed instructions, so the
+                    // message can be rejected without reading the rest
+                    if (stream->display_count == MAX_DISPLAYED_INSTRUCTIONS ||
+                        stream->offset > UINT16_MAX) {
+                        stream->state = MessageStreamUnrecognized;
+                        break;
+                    }
+                    stream->display_codes[stream->display_count] = code;
+                    stream->display_offsets[stream->display_count] = stream->offset;
+                    stream->display_count++;
+                }
+                message_stream_advance(stream, message, &parser);
+                if (++stream->instruction_count < header->instructions_length) {
+                    break;
+                }
+                if (header->versioned) {
+                    stream->state = MessageStreamTrailer;
+                } else {
+                    stream->state = message_stream_select_printer(stream);
                 }
                 break;
             }
-            case ProgramIdVote: {
-                if (parse_vote_instructions(&instruction, header, &info->vote) == 0) {
-                    info->kind = program_id;
+            case MessageStreamTrailer: {
+                size_t account_tables_length;
+                if (parse_length(&parser, &account_tables_length) != 0) {
+                    return message_stream_short_read(stream,
+                                                     last_chunk,
+                                                     MessageStreamUnrecognized);
+                }
+                message_stream_advance(stream, message, &parser);
+                if (account_tables_length > 0) {
+                    stream->state = MessageStreamUnrecognized;
+                } else {
+                    stream->state = message_stream_select_printer(stream);
                 }
                 break;
             }
-            case ProgramIdUnknown:
-                break;
-        }
-        switch (info->kind) {
-            case ProgramIdSplAssociatedTokenAccount:
-            case ProgramIdSplToken:
-            case ProgramIdSystem:
-            case ProgramIdStake:
-            case ProgramIdVote:
-            case ProgramIdUnknown:
-                display_instruction_info[display_instruction_count++] = info;
-                break;
-            // Ignored instructions
-            case ProgramIdSerumAssertOwner:
-            case ProgramIdSplMemo:
-                break;
+            case MessageStreamComplete:
+                // Ensure nothing follows the message body
+                if (!parser_is_empty(&parser)) {
+                    stream->state = MessageStreamUnrecognized;
+                }
+                return stream->state;
+            case MessageStreamUnrecognized:
+            case MessageStreamInvalid:
+                return stream->state;
         }
     }
+}
 
-    if (header->versioned) {
-        size_t account_tables_length;
-        BAIL_IF(parse_length(&parser, &account_tables_length));
-        BAIL_IF(account_tables_length > 0);
+enum MessageStreamState message_stream_update(const uint8_t* message,
+                                              size_t message_length,
+                                              bool last_chunk) {
+    return message_stream_decode(&G_message_stream, message, message_length, last_chunk);
+}
+
+const MessageHeader* message_stream_header() {
+    switch (G_message_stream.state) {
+        case MessageStreamHeader:
+        case MessageStreamInvalid:
+            break;
+        case MessageStreamInstructions:
+        case MessageStreamTrailer:
+        case MessageStreamComplete:
+        case MessageStreamUnrecognized:
+            return &G_message_stream.header;
     }
+    return NULL;
+}
 
-    // Ensure we've consumed the entire message body
-    BAIL_IF(!parser_is_empty(&parser));
+enum MessageStreamState message_stream_state() {
+    return G_message_stream.state;
+}
 
-    // If we don't know about all of the instructions, bail
-    for (size_t i = 0; i < instruction_count; i++) {
-        BAIL_IF(instruction_info[i].kind == ProgramIdUnknown);
-    }
+static int message_stream_print_into(MessageStream* stream,
+                                     const uint8_t* message,
+                                     size_t message_length,
+                                     uint8_t* arena,
+                                     size_t arena_size,
+                                     const PrintConfig* print_config) {
+    BAIL_IF(stream->state != MessageStreamComplete);
+    BAIL_IF(message_stream_decode_displayed(stream, message, message_length, arena, arena_size));
+    return print_transaction(print_config, stream->pool.infos, stream->pool.count);
+}
+
+int message_stream_print(const uint8_t* message,
+                         size_t message_length,
+                         uint8_t* arena,
+                         size_t arena_size,
+                         const PrintConfig* print_config) {
+    return message_stream_print_into(&G_message_stream,
+                                     message,
+                                     message_length,
+                                     arena,
+                                     arena_size,
+                                     print_config);
+}
+
+// Decodes on its own stream and prints into `print_config->summary`, so
+// separate contexts may be processed concurrently on the host
+int process_message_body(const uint8_t* message_body,
+                         int message_body_length,
+                         const PrintConfig* print_config) {
+    MessageStream stream;
+    _Alignas(InstructionInfo) uint8_t arena[MESSAGE_STREAM_ARENA_SIZE];
+
+    // The header is already parsed, so decode the body as one final chunk
+    message_stream_init(&stream);
+    stream.header = print_config->header;
+    message_stream_begin_body(&stream);
+    BAIL_IF(stream.state != MessageStreamInstructions);
+    BAIL_IF(message_stream_decode(&stream, message_body, message_body_length, true) !=
+            MessageStreamComplete);
 
-    return print_transaction(print_config, display_instruction_info, display_instruction_count);
+    return message_stream_print_into(&stream,
+                                     message_body,
+                                     message_body_length,
+                                     arena,
+                                     sizeof(arena),
+                                     print_config);
 }
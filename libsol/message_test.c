@@ -28,6 +28,29 @@ void test_process_message_body_ok() {
     assert(num_kinds == 4);
 }
 
+void test_process_message_body_own_context_ok() {
+    Pubkey accounts[] = {
+        {{171, 88, 202, 32, 185, 160, 182, 116, 130, 185, 73, 48, 13, 216, 170, 71, 172, 195, 165, 123, 87, 70, 130, 219, 5, 157, 240, 187, 26, 191, 158, 218}},
+        {{204, 241, 115, 109, 41, 173, 110, 48, 24, 113, 210, 213, 163, 78, 1, 112, 146, 114, 235, 220, 96, 185, 184, 85, 163, 27, 124, 48, 54, 250, 233, 54}},
+        {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    };
+    Blockhash blockhash = {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+    TransactionSummaryContext context;
+    PrintConfig print_config = { .header = {false, 0, {1, 0, 1, 3}, accounts, &blockhash, 1}, .expert_mode = true, .summary = &context };
+    uint8_t msg_body[] = {2, 2, 0, 1, 12, 2, 0, 0, 0, 42, 0, 0, 0, 0, 0, 0, 0};
+
+    summary_context_reset(&context);
+    transaction_summary_reset();
+    assert(process_message_body(msg_body, ARRAY_LEN(msg_body), &print_config) == 0);
+    summary_context_set_fee_payer_pubkey(&context, &print_config.header.pubkeys[0]);
+    enum SummaryItemKind kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
+    size_t num_kinds;
+    assert(summary_context_finalize(&context, kinds, &num_kinds) == 0);
+    assert(num_kinds == 4);
+    // Nothing was printed into the global summary
+    assert(transaction_summary_finalize(kinds, &num_kinds) == 1);
+}
+
 void test_process_message_body_xfer_w_nonce_ok() {
     Pubkey accounts[] = {
         {{171, 88, 202, 32, 185, 160, 182, 116, 130, 185, 73, 48, 13, 216, 170, 71, 172, 195, 165, 123, 87, 70, 130, 219, 5, 157, 240, 187, 26, 191, 158, 218}},
@@ -75,6 +98,37 @@ void test_process_message_body_too_many_ix_fail() {
     assert(process_message_body(msg_body, ARRAY_LEN(msg_body), &print_config) == 1);
 }
 
+void test_process_message_body_many_ix_ok() {
+    Pubkey accounts[] = {
+        {{171, 88, 202, 32, 185, 160, 182, 116, 130, 185, 73, 48, 13, 216, 170, 71, 172, 195, 165, 123, 87, 70, 130, 219, 5, 157, 240, 187, 26, 191, 158, 218}},
+        {{204, 241, 115, 109, 41, 173, 110, 48, 24, 113, 210, 213, 163, 78, 1, 112, 146, 114, 235, 220, 96, 185, 184, 85, 163, 27, 124, 48, 54, 250, 233, 54}},
+        {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+        {{PROGRAM_ID_SPL_MEMO}},
+    };
+    Blockhash blockhash = {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+    uint8_t memo_ix[] = {3, 0, 4, 'm', 'e', 'm', 'o'};
+    uint8_t xfer_ix[] = {2, 2, 0, 1, 12, 2, 0, 0, 0, 42, 0, 0, 0, 0, 0, 0, 0};
+
+#define MANY_MEMO_IX (MAX_INSTRUCTIONS - 1)
+#define MEMO_IX_LEN ARRAY_LEN(memo_ix)
+
+    // More instructions than the former limit of four
+    uint8_t msg_body[ARRAY_LEN(xfer_ix) + MANY_MEMO_IX * MEMO_IX_LEN];
+    memcpy(msg_body, xfer_ix, ARRAY_LEN(xfer_ix));
+    for (size_t i = 0; i < MANY_MEMO_IX; i++) {
+        memcpy(msg_body + ARRAY_LEN(xfer_ix) + (i * MEMO_IX_LEN), memo_ix, MEMO_IX_LEN);
+    }
+    PrintConfig print_config = { .header = {false, 0, {1, 0, 2, 4}, accounts, &blockhash, MAX_INSTRUCTIONS}, .expert_mode = true };
+
+    transaction_summary_reset();
+    assert(process_message_body(msg_body, ARRAY_LEN(msg_body), &print_config) == 0);
+    transaction_summary_set_fee_payer_pubkey(&print_config.header.pubkeys[0]);
+    enum SummaryItemKind kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
+    size_t num_kinds;
+    assert(transaction_summary_finalize(kinds, &num_kinds) == 0);
+    assert(num_kinds == 4);
+}
+
 void test_process_message_body_data_too_short_fail() {
     PrintConfig print_config = { .header = {false, 0, {0, 0, 0, 0}, NULL, NULL, 1}, .expert_mode = true };
     assert(process_message_body(NULL, 0, &print_config) == 1);
@@ -132,6 +186,7 @@ void test_process_message_body_ix_with_unknown_program_id_fail() {
 static void process_message_body_and_sanity_check(const uint8_t* message, size_t message_length, size_t expected_fields) {
     PrintConfig print_config;
     print_config.expert_mode = true;
+    print_config.summary = NULL;
     Parser parser = { message, message_length };
     assert(parse_message_header(&parser, &print_config.header) == 0);
     transaction_summary_reset();
@@ -145,6 +200,27 @@ static void process_message_body_and_sanity_check(const uint8_t* message, size_t
     for (size_t i = 0; i < num_kinds; i++) {
         assert(transaction_summary_display_item(i, DisplayFlagNone) == 0);
     }
+
+    // Streaming the same message in chunks must produce the same summary
+    const size_t chunk_sizes[] = { 1, 64, 255, message_length };
+    _Alignas(uint64_t) uint8_t arena[MESSAGE_STREAM_ARENA_SIZE];
+    for (size_t c = 0; c < ARRAY_LEN(chunk_sizes); c++) {
+        message_stream_reset();
+        enum MessageStreamState state = MessageStreamHeader;
+        for (size_t length = 0; length < message_length;) {
+            length = MIN(length + chunk_sizes[c], message_length);
+            state = message_stream_update(message, length, length == message_length);
+            assert(state != MessageStreamUnrecognized && state != MessageStreamInvalid);
+        }
+        assert(state == MessageStreamComplete);
+        print_config.header = *message_stream_header();
+        transaction_summary_reset();
+        assert(message_stream_print(message, message_length, arena, sizeof(arena), &print_config) == 0);
+        transaction_summary_set_fee_payer_pubkey(&print_config.header.pubkeys[0]);
+        size_t num_stream_kinds;
+        assert(transaction_summary_finalize(kinds, &num_stream_kinds) == 0);
+        assert(num_stream_kinds == expected_fields);
+    }
 }
 
 void test_process_message_body_nonced_stake_create_with_seed() {
@@ -1861,9 +1937,196 @@ void test_process_message_body_spl_associated_token_create_with_transfer_and_ass
     process_message_body_and_sanity_check(message, sizeof(message), 9);
 }
 
+void test_message_stream_unknown_program_id_rejected_early() {
+    uint8_t message[] = {
+        1, 0, 1,
+        3,
+            BYTES32_BS58_2,
+            BYTES32_BS58_3,
+            BYTES32_BS58_4,
+        BLOCKHASH,
+        2,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+    };
+    const size_t first_ix_end = sizeof(message) - 17;
+    _Alignas(uint64_t) uint8_t arena[MESSAGE_STREAM_ARENA_SIZE];
+
+    message_stream_reset();
+    assert(message_stream_header() == NULL);
+    assert(message_stream_update(message, first_ix_end - 1, false) == MessageStreamInstructions);
+    assert(message_stream_header() != NULL);
+    assert(message_stream_update(message, first_ix_end, false) == MessageStreamUnrecognized);
+    assert(message_stream_update(message, sizeof(message), true) == MessageStreamUnrecognized);
+    assert(message_stream_print(message, sizeof(message), arena, sizeof(arena), NULL) == 1);
+}
+
+void test_message_stream_unprintable_not_decoded() {
+    // Two system transfers have no summary
+    uint8_t message[] = {
+        1, 0, 1,
+        3,
+            BYTES32_BS58_2,
+            BYTES32_BS58_3,
+            PROGRAM_ID_SYSTEM,
+        BLOCKHASH,
+        2,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+    };
+    _Alignas(uint64_t) uint8_t arena[MESSAGE_STREAM_ARENA_SIZE];
+
+    message_stream_reset();
+    assert(message_stream_update(message, sizeof(message), true) == MessageStreamUnrecognized);
+    assert(G_message_stream.display_count == 2);
+    assert(G_message_stream.pool.count == 0);
+    assert(message_stream_print(message, sizeof(message), arena, sizeof(arena), NULL) == 1);
+}
+
+void test_message_stream_too_many_displayed_rejected_early() {
+    // One more displayed instruction than any printer takes, and a memo
+    uint8_t message[] = {
+        1, 0, 2,
+        4,
+            BYTES32_BS58_2,
+            BYTES32_BS58_3,
+            PROGRAM_ID_SYSTEM,
+            PROGRAM_ID_SPL_MEMO,
+        BLOCKHASH,
+        6,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            3,
+            0,
+            4,
+                'm', 'e', 'm', 'o',
+    };
+    const size_t last_ix_start = sizeof(message) - 7;
+
+    message_stream_reset();
+    assert(message_stream_update(message, last_ix_start - 17, false) == MessageStreamInstructions);
+    assert(G_message_stream.display_count == MAX_DISPLAYED_INSTRUCTIONS);
+    assert(message_stream_update(message, last_ix_start, false) == MessageStreamUnrecognized);
+    assert(message_stream_update(message, sizeof(message), true) == MessageStreamUnrecognized);
+}
+
+void test_message_stream_unknown_kind_rejected_early() {
+    uint8_t message[] = {
+        1, 0, 1,
+        3,
+            BYTES32_BS58_2,
+            BYTES32_BS58_3,
+            PROGRAM_ID_SYSTEM,
+        BLOCKHASH,
+        2,
+            2,
+            2,
+                0, 1,
+            12,
+                255, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+    };
+    const size_t first_ix_end = sizeof(message) - 17;
+
+    message_stream_reset();
+    assert(message_stream_update(message, first_ix_end, false) == MessageStreamUnrecognized);
+}
+
+void test_message_stream_truncated() {
+    uint8_t message[] = {
+        1, 0, 1,
+        3,
+            BYTES32_BS58_2,
+            BYTES32_BS58_3,
+            PROGRAM_ID_SYSTEM,
+        BLOCKHASH,
+        1,
+            2,
+            2,
+                0, 1,
+            12,
+                2, 0, 0, 0,
+                42, 0, 0, 0, 0, 0, 0, 0,
+    };
+
+    // Truncated header
+    message_stream_reset();
+    assert(message_stream_update(message, 40, false) == MessageStreamHeader);
+    assert(message_stream_update(message, 41, true) == MessageStreamInvalid);
+    assert(message_stream_header() == NULL);
+
+    // Truncated body
+    message_stream_reset();
+    assert(message_stream_update(message, sizeof(message) - 1, false) == MessageStreamInstructions);
+    assert(message_stream_update(message, sizeof(message) - 1, true) == MessageStreamUnrecognized);
+
+    // Trailing data
+    uint8_t padded[sizeof(message) + 1] = {0};
+    memcpy(padded, message, sizeof(message));
+    message_stream_reset();
+    assert(message_stream_update(padded, sizeof(message) - 1, false) == MessageStreamInstructions);
+    assert(message_stream_update(padded, sizeof(message), false) == MessageStreamComplete);
+    assert(message_stream_update(padded, sizeof(padded), true) == MessageStreamUnrecognized);
+}
+
 /* clang-format on */
 
 int main() {
+    test_process_message_body_own_context_ok();
     test_process_message_body_spl_associated_token_create_with_transfer_and_assert_owner();
     test_process_message_body_spl_associated_token_create_with_transfer();
     test_process_message_body_spl_associated_token_create();
@@ -1883,6 +2146,7 @@ int main() {
     test_process_message_body_ok();
     test_process_message_body_too_few_ix_fail();
     test_process_message_body_too_many_ix_fail();
+    test_process_message_body_many_ix_ok();
     test_process_message_body_data_too_short_fail();
     test_process_message_body_data_too_long_fail();
     test_process_message_body_bad_ix_account_index_fail();
@@ -1931,6 +2195,11 @@ int main() {
     test_process_message_body_stake_split_with_seed_v1_1();
     test_process_message_body_stake_split_with_seed_v1_2();
     test_process_message_body_stake_merge();
+    test_message_stream_unknown_program_id_rejected_early();
+    test_message_stream_truncated();
+    test_message_stream_unprintable_not_decoded();
+    test_message_stream_too_many_displayed_rejected_early();
+    test_message_stream_unknown_kind_rejected_early();
 
     printf("passed\n");
     return 0;
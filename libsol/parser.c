@@ -14,6 +14,13 @@ static void advance(Parser* parser, size_t num) {
     parser->buffer_length -= num;
 }
 
+int parse_record(Parser* parser, size_t size, Record* record) {
+    BAIL_IF(check_buffer_length(parser, size));
+    record->cursor = parser->buffer;
+    advance(parser, size);
+    return 0;
+}
+
 int parse_u8(Parser* parser, uint8_t* value) {
     BAIL_IF(check_buffer_length(parser, 1));
     *value = *parser->buffer;
@@ -22,27 +29,23 @@ int parse_u8(Parser* parser, uint8_t* value) {
 }
 
 static int parse_u16(Parser* parser, uint16_t* value) {
-    uint8_t lower, upper;
-    BAIL_IF(parse_u8(parser, &lower));
-    BAIL_IF(parse_u8(parser, &upper));
-    *value = lower + ((uint16_t) upper << 8);
+    BAIL_IF(check_buffer_length(parser, sizeof(*value)));
+    *value = load_u16_le(parser->buffer);
+    advance(parser, sizeof(*value));
     return 0;
 }
 
 int parse_u32(Parser* parser, uint32_t* value) {
-    uint16_t lower, upper;
-    BAIL_IF(parse_u16(parser, &lower));
-    BAIL_IF(parse_u16(parser, &upper));
-    *value = lower + ((uint32_t) upper << 16);
+    BAIL_IF(check_buffer_length(parser, sizeof(*value)));
+    *value = load_u32_le(parser->buffer);
+    advance(parser, sizeof(*value));
     return 0;
 }
 
 int parse_u64(Parser* parser, uint64_t* value) {
-    BAIL_IF(check_buffer_length(parser, 8));
-    uint32_t lower, upper;
-    BAIL_IF(parse_u32(parser, &lower));
-    BAIL_IF(parse_u32(parser, &upper));
-    *value = lower + ((uint64_t) upper << 32);
+    BAIL_IF(check_buffer_length(parser, sizeof(*value)));
+    *value = load_u64_le(parser->buffer);
+    advance(parser, sizeof(*value));
     return 0;
 }
 
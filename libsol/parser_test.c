@@ -69,6 +69,28 @@ void test_parse_i64() {
     assert(value == INT64_MAX);
 }
 
+void test_parse_record() {
+    uint8_t message[] = {42, 1, 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 7};
+    Parser parser = {message, sizeof(message)};
+    Record record;
+    assert(parse_record(&parser, 13, &record) == 0);
+    assert(parser.buffer_length == 1);
+    assert(parser.buffer == message + 13);
+    assert(record_u8(&record) == 42);
+    assert(record_u32(&record) == 1);
+    assert(record_u64(&record) == UINT64_MAX);
+    assert(record.cursor == message + 13);
+}
+
+void test_parse_record_too_short() {
+    uint8_t message[] = {1, 2, 3};
+    Parser parser = {message, sizeof(message)};
+    Record record;
+    assert(parse_record(&parser, 4, &record) == 1);
+    assert(parser.buffer_length == 3);
+    assert(parser.buffer == message);
+}
+
 void test_parse_length() {
     uint8_t message[] = {1, 2};
     Parser parser = {message, sizeof(message)};
@@ -327,6 +349,8 @@ int main() {
     test_parse_u32();
     test_parse_u64();
     test_parse_i64();
+    test_parse_record();
+    test_parse_record_too_short();
     test_parse_length();
     test_parse_length_two_bytes();
     test_parse_sized_string();
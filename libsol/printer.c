@@ -8,52 +8,111 @@
 // max amount is max uint64 scaled down: "18446744073.709551615"
 #define AMOUNT_MAX_SIZE 22
 
+// "18446744073709551615"
+#define U64_MAX_DIGITS 20
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// High 64 bits of the 128-bit product, from 32-bit partial products
+static uint64_t mul_high_u64(uint64_t a, uint64_t b) {
+    const uint64_t a_lo = (uint32_t) a;
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = (uint32_t) b;
+    const uint64_t b_hi = b >> 32;
+    const uint64_t hi_lo = a_hi * b_lo;
+    // Cannot overflow: at most 2 * (2^32 - 1) + (2^32 - 1)^2
+    const uint64_t cross = ((a_lo * b_lo) >> 32) + (uint32_t) hi_lo + a_lo * b_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+// Exact for any u64: floor(value * ceil(2^90 / 10^8) / 2^90) == value / 10^8
+static uint64_t div_1e8(uint64_t value) {
+    return mul_high_u64(value, 0xABCC77118461CEFDULL) >> 26;
+}
+
+// Writes the 4 digits of `quad` < 10^4, two at a time
+static void format_u32_quad(uint32_t quad, char *out) {
+    const uint32_t high = (quad * 5243) >> 19;  // quad / 100
+    memcpy(out, &DIGIT_PAIRS[2 * high], 2);
+    memcpy(out + 2, &DIGIT_PAIRS[2 * (quad - high * 100)], 2);
+}
+
+// Writes the 8 digits of `chunk` < 10^8
+static void format_u32_chunk(uint32_t chunk, char *out) {
+    const uint32_t high = (uint32_t) (((uint64_t) chunk * 109951163) >> 40);  // chunk / 10^4
+    format_u32_quad(high, out);
+    format_u32_quad(chunk - high * 10000, out + 4);
+}
+
+// Writes `value` as U64_MAX_DIGITS zero-padded digits. Returns the number of
+// significant digits, at least one
+static size_t format_u64_digits(uint64_t value, char digits[U64_MAX_DIGITS]) {
+    char chunks[3 * 8];
+    const uint64_t high = div_1e8(value);
+    const uint64_t top = div_1e8(high);
+    format_u32_chunk((uint32_t) top, chunks);
+    format_u32_chunk((uint32_t) (high - top * 100000000), chunks + 8);
+    format_u32_chunk((uint32_t) (value - high * 100000000), chunks + 16);
+    memcpy(digits, chunks + sizeof(chunks) - U64_MAX_DIGITS, U64_MAX_DIGITS);
+
+    size_t length = U64_MAX_DIGITS;
+    while (length > 1 && digits[U64_MAX_DIGITS - length] == '0') {
+        length--;
+    }
+    return length;
+}
+
 int print_token_amount(uint64_t amount,
                        const char *const asset,
                        uint8_t decimals,
                        char *out,
                        const size_t out_length) {
     BAIL_IF(out_length > INT_MAX);
-    uint64_t dVal = amount;
-    const int outlen = (int) out_length;
-    int i = 0;
-    int min_chars = decimals + 1;
-
-    if (i < (outlen - 1)) {
-        do {
-            if (i == decimals) {
-                out[i] = '.';
-                i += 1;
-            }
-            out[i] = (dVal % 10) + '0';
-            dVal /= 10;
-            i += 1;
-        } while ((dVal > 0 || i < min_chars) && i < outlen);
-    }
-    BAIL_IF(i >= outlen);
-    // Reverse order
-    int j, k;
-    for (j = 0, k = i - 1; j < k; j++, k--) {
-        char tmp = out[j];
-        out[j] = out[k];
-        out[k] = tmp;
-    }
-    // Strip trailing 0s
-    for (i -= 1; i > 0; i--) {
-        if (out[i] != '0') break;
-    }
-    i += 1;
-
-    // Strip trailing .
-    if (out[i - 1] == '.') i -= 1;
+    char digits[U64_MAX_DIGITS];
+    const size_t digits_length = format_u64_digits(amount, digits);
+    // Left pad with zeros to print at least one integer digit
+    const size_t padded_length =
+        (digits_length > decimals) ? digits_length : (size_t) decimals + 1;
+    const size_t padding = padded_length - digits_length;
+    const char *const first_digit = digits + U64_MAX_DIGITS - digits_length;
+    const size_t integer_length = padded_length - decimals;
+
+    // Room is required for all digits and the point, before any is stripped
+    BAIL_IF(padded_length + 1 >= out_length);
+
+    // Trailing zeros of the fraction, and the point if nothing is left of it,
+    // are stripped by ending the output after the last significant digit
+    size_t i = 0;
+    size_t end = 0;
+    for (size_t k = 0; k < padded_length; k++) {
+        if (k == integer_length) {
+            out[i++] = '.';
+        }
+        const char digit = (k < padding) ? '0' : first_digit[k - padding];
+        out[i++] = digit;
+        if (k < integer_length || digit != '0') {
+            end = i;
+        }
+    }
+    i = end;
 
     if (asset) {
-        const int asset_length = strlen(asset);
+        const size_t asset_length = strlen(asset);
         // Check buffer has space
-        BAIL_IF((i + 1 + asset_length + 1) > outlen);
+        BAIL_IF((i + 1 + asset_length + 1) > out_length);
         // Qualify amount
         out[i++] = ' ';
-        strncpy(out + i, asset, asset_length + 1);
+        memcpy(out + i, asset, asset_length + 1);
     } else {
         out[i] = '\0';
     }
@@ -122,42 +181,94 @@ static const char BASE58_ALPHABET[] = {'1', '2', '3', '4', '5', '6', '7', '8', '
                                        'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'm', 'n', 'o', 'p',
                                        'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
 
+#define BASE58_MAX_INPUT_LENGTH 64
+#define BASE58_MAX_LIMBS        (BASE58_MAX_INPUT_LENGTH / sizeof(uint32_t))
+// Each pass divides the limbs by 58^2 and yields two digits at once. A limb is
+// divided as two 16-bit halves, so that every step fits 32 bits: the devices
+// have no 64-bit divide
+#define BASE58_PASS_DIGITS 2
+#define BASE58_PASS_BASE   3364U  // 58^2
+
+// Encodes the big-endian number held in `limbs` into base58 digits, written
+// backwards ending at `digits + digits_end`. `limbs` is consumed. Returns the
+// index of the most significant non-zero digit
+static inline size_t base58_encode_limbs(uint32_t *limbs,
+                                         size_t limb_count,
+                                         char *digits,
+                                         size_t digits_end) {
+    size_t start_at = 0;
+    size_t j = digits_end;
+    while (start_at < limb_count && limbs[start_at] == 0) {
+        ++start_at;
+    }
+    while (start_at < limb_count) {
+        uint32_t remainder = 0;
+        for (size_t i = start_at; i < limb_count; i++) {
+            // remainder < 58^2 < 2^12, both halves stay below 2^28
+            const uint32_t high = (remainder << 16) | (limbs[i] >> 16);
+            remainder = high % BASE58_PASS_BASE;
+            const uint32_t low = (remainder << 16) | (limbs[i] & 0xffff);
+            remainder = low % BASE58_PASS_BASE;
+            limbs[i] = (high / BASE58_PASS_BASE) << 16 | (low / BASE58_PASS_BASE);
+        }
+        while (start_at < limb_count && limbs[start_at] == 0) {
+            ++start_at;
+        }
+        uint32_t pass_digits = remainder;
+        for (size_t i = 0; i < BASE58_PASS_DIGITS; i++) {
+            digits[--j] = BASE58_ALPHABET[pass_digits % 58];
+            pass_digits /= 58;
+        }
+    }
+    // Drop the zeros padding the last pass
+    while (j < digits_end && digits[j] == BASE58_ALPHABET[0]) {
+        ++j;
+    }
+    return j;
+}
+
 int encode_base58(const void *in, size_t length, char *out, size_t maxoutlen) {
-    uint8_t tmp[64];
-    uint8_t buffer[64];
-    uint8_t j;
-    size_t start_at;
+    const uint8_t *bytes = in;
+    uint32_t limbs[BASE58_MAX_LIMBS];
+    // Leading zeros plus at most 1.37 digits per byte, and a partial pass
+    char buffer[2 * BASE58_MAX_INPUT_LENGTH];
     size_t zero_count = 0;
-    if (length > sizeof(tmp)) {
+    size_t j;
+
+    if (length > BASE58_MAX_INPUT_LENGTH) {
         return INVALID_PARAMETER;
     }
-    memmove(tmp, in, length);
-    while ((zero_count < length) && (tmp[zero_count] == 0)) {
+    while ((zero_count < length) && (bytes[zero_count] == 0)) {
         ++zero_count;
     }
-    j = 2 * length;
-    start_at = zero_count;
-    while (start_at < length) {
-        uint16_t remainder = 0;
-        size_t div_loop;
-        for (div_loop = start_at; div_loop < length; div_loop++) {
-            uint16_t digit256 = (uint16_t) (tmp[div_loop] & 0xff);
-            uint16_t tmp_div = remainder * 256 + digit256;
-            tmp[div_loop] = (uint8_t) (tmp_div / 58);
-            remainder = (tmp_div % 58);
-        }
-        if (tmp[start_at] == 0) {
-            ++start_at;
+
+    // Load big-endian limbs, the first one holding the leading length % 4 bytes
+    const size_t limb_count = (length + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    size_t limb = 0;
+    size_t pending = length % sizeof(uint32_t);
+    uint32_t value = 0;
+    if (pending == 0) {
+        pending = sizeof(uint32_t);
+    }
+    for (size_t i = 0; i < length; i++) {
+        value = (value << 8) | bytes[i];
+        if (--pending == 0) {
+            limbs[limb++] = value;
+            value = 0;
+            pending = sizeof(uint32_t);
         }
-        buffer[--j] = (uint8_t) BASE58_ALPHABET[remainder];
     }
-    while ((j < (2 * length)) && (buffer[j] == BASE58_ALPHABET[0])) {
-        ++j;
+
+    // Pubkeys and hashes get a copy with a constant limb count the compiler can unroll
+    if (limb_count == PUBKEY_SIZE / sizeof(uint32_t)) {
+        j = base58_encode_limbs(limbs, PUBKEY_SIZE / sizeof(uint32_t), buffer, sizeof(buffer));
+    } else {
+        j = base58_encode_limbs(limbs, limb_count, buffer, sizeof(buffer));
     }
     while (zero_count-- > 0) {
         buffer[--j] = BASE58_ALPHABET[0];
     }
-    length = 2 * length - j;
+    length = sizeof(buffer) - j;
     if (maxoutlen < length + 1) {
         return EXCEPTION_OVERFLOW;
     }
@@ -180,32 +291,12 @@ int print_i64(int64_t i64, char *out, size_t out_length) {
 
 int print_u64(uint64_t u64, char *out, size_t out_length) {
     BAIL_IF(out_length > INT_MAX);
-    uint64_t dVal = u64;
-    int outlen = (int) out_length;
-    int i = 0;
-    int j = 0;
+    char digits[U64_MAX_DIGITS];
+    const size_t length = format_u64_digits(u64, digits);
 
-    if (i < (outlen - 1)) {
-        do {
-            if (dVal > 0) {
-                out[i] = (dVal % 10) + '0';
-                dVal /= 10;
-            } else {
-                out[i] = '0';
-            }
-            i++;
-        } while (dVal > 0 && i < outlen);
-    }
-
-    BAIL_IF(i >= outlen);
-
-    out[i--] = '\0';
-
-    for (; j < i; j++, i--) {
-        int tmp = out[j];
-        out[j] = out[i];
-        out[i] = tmp;
-    }
+    BAIL_IF(length >= out_length);
+    memcpy(out, digits + U64_MAX_DIGITS - length, length);
+    out[length] = '\0';
 
     return 0;
 }
@@ -1,3 +1,4 @@
+#include "common_byte_strings.h"
 #include "printer.c"
 #include <assert.h>
 #include <stdio.h>
@@ -142,6 +143,233 @@ void test_print_timestamp() {
     assert(print_timestamp(0, out, sizeof(out) - 1) == 1);
 }
 
+// The digit by digit formatters, kept as reference for the current ones
+static int print_token_amount_reference(uint64_t amount,
+                                        const char *const asset,
+                                        uint8_t decimals,
+                                        char *out,
+                                        const size_t out_length) {
+    uint64_t dVal = amount;
+    const int outlen = (int) out_length;
+    int i = 0;
+    int min_chars = decimals + 1;
+
+    do {
+        if (i == decimals) {
+            out[i] = '.';
+            i += 1;
+        }
+        out[i] = (dVal % 10) + '0';
+        dVal /= 10;
+        i += 1;
+    } while ((dVal > 0 || i < min_chars) && i < outlen);
+    if (i >= outlen) {
+        return 1;
+    }
+    for (int j = 0, k = i - 1; j < k; j++, k--) {
+        char tmp = out[j];
+        out[j] = out[k];
+        out[k] = tmp;
+    }
+    for (i -= 1; i > 0; i--) {
+        if (out[i] != '0') break;
+    }
+    i += 1;
+    if (out[i - 1] == '.') i -= 1;
+    if (asset) {
+        const int asset_length = strlen(asset);
+        if ((i + 1 + asset_length + 1) > outlen) {
+            return 1;
+        }
+        out[i++] = ' ';
+        strncpy(out + i, asset, asset_length + 1);
+    } else {
+        out[i] = '\0';
+    }
+    return 0;
+}
+
+static int print_u64_reference(uint64_t u64, char *out, size_t out_length) {
+    char tmp[U64_MAX_DIGITS + 1];
+    size_t i = 0;
+    do {
+        tmp[i++] = (u64 % 10) + '0';
+        u64 /= 10;
+    } while (u64 > 0);
+    if (i >= out_length) {
+        return 1;
+    }
+    for (size_t j = 0; j < i; j++) {
+        out[j] = tmp[i - 1 - j];
+    }
+    out[i] = '\0';
+    return 0;
+}
+
+static void assert_amount_matches_reference(uint64_t amount, uint8_t decimals) {
+    // Every size from too short to large enough, with and without an asset
+    for (size_t out_length = 2; out_length <= 48; out_length++) {
+        char out[48];
+        char expected[64];
+        int rc = print_token_amount_reference(amount, "TST", decimals, expected, out_length);
+        assert(print_token_amount(amount, "TST", decimals, out, out_length) == rc);
+        if (rc == 0) {
+            assert_string_equal(out, expected);
+        }
+        rc = print_token_amount_reference(amount, NULL, decimals, expected, out_length);
+        assert(print_token_amount(amount, NULL, decimals, out, out_length) == rc);
+        if (rc == 0) {
+            assert_string_equal(out, expected);
+        }
+    }
+    for (size_t out_length = 1; out_length <= 22; out_length++) {
+        char out[22];
+        char expected[22];
+        int rc = print_u64_reference(amount, expected, out_length);
+        assert(print_u64(amount, out, out_length) == rc);
+        if (rc == 0) {
+            assert_string_equal(out, expected);
+        }
+    }
+}
+
+void test_print_matches_reference() {
+    const uint64_t edges[] = {
+        0,
+        1,
+        9,
+        10,
+        99999999,
+        100000000,
+        100000001,
+        9999999999999999,
+        10000000000000000,
+        10000000000000001,
+        10000000000000000000ULL,
+        UINT64_MAX - 1,
+        UINT64_MAX,
+    };
+    uint64_t state = 0x123456789abcdefULL;
+
+    for (uint8_t decimals = 0; decimals <= 24; decimals++) {
+        for (size_t i = 0; i < ARRAY_LEN(edges); i++) {
+            assert_amount_matches_reference(edges[i], decimals);
+        }
+        for (size_t i = 0; i < 64; i++) {
+            // xorshift64, then trailing zeros and a random magnitude
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            uint64_t amount = state >> (state % 64);
+            for (size_t zeros = i % 12; zeros > 0 && amount <= UINT64_MAX / 10; zeros--) {
+                amount *= 10;
+            }
+            assert_amount_matches_reference(amount, decimals);
+        }
+    }
+}
+
+// The byte-wise long division encoder, kept as reference for encode_base58
+static int encode_base58_reference(const void *in, size_t length, char *out, size_t maxoutlen) {
+    uint8_t tmp[64];
+    uint8_t buffer[128];
+    uint8_t j;
+    size_t start_at;
+    size_t zero_count = 0;
+    if (length > sizeof(tmp)) {
+        return INVALID_PARAMETER;
+    }
+    memmove(tmp, in, length);
+    while ((zero_count < length) && (tmp[zero_count] == 0)) {
+        ++zero_count;
+    }
+    j = 2 * length;
+    start_at = zero_count;
+    while (start_at < length) {
+        uint16_t remainder = 0;
+        for (size_t div_loop = start_at; div_loop < length; div_loop++) {
+            uint16_t tmp_div = remainder * 256 + tmp[div_loop];
+            tmp[div_loop] = (uint8_t) (tmp_div / 58);
+            remainder = (tmp_div % 58);
+        }
+        if (tmp[start_at] == 0) {
+            ++start_at;
+        }
+        buffer[--j] = (uint8_t) BASE58_ALPHABET[remainder];
+    }
+    while ((j < (2 * length)) && (buffer[j] == BASE58_ALPHABET[0])) {
+        ++j;
+    }
+    while (zero_count-- > 0) {
+        buffer[--j] = BASE58_ALPHABET[0];
+    }
+    length = 2 * length - j;
+    if (maxoutlen < length + 1) {
+        return EXCEPTION_OVERFLOW;
+    }
+    memmove(out, (buffer + j), length);
+    out[length] = '\0';
+    return 0;
+}
+
+static void assert_base58_matches_reference(const uint8_t *in, size_t length) {
+    char out[128];
+    char expected[128];
+    assert(encode_base58_reference(in, length, expected, sizeof(expected)) == 0);
+    assert(encode_base58(in, length, out, sizeof(out)) == 0);
+    assert_string_equal(out, expected);
+}
+
+void test_encode_base58() {
+    char out[BASE58_PUBKEY_LENGTH];
+
+    const uint8_t zeros[] = {BYTES32_BS58_1};
+    assert(encode_base58(zeros, sizeof(zeros), out, sizeof(out)) == 0);
+    assert_string_equal(out, "11111111111111111111111111111111");
+    const uint8_t twos[] = {BYTES32_BS58_2};
+    assert(encode_base58(twos, sizeof(twos), out, sizeof(out)) == 0);
+    assert_string_equal(out, "22222222222222222222222222222222222222222222");
+
+    assert(encode_base58(twos, 0, out, sizeof(out)) == 0);
+    assert_string_equal(out, "");
+    const uint8_t leading_zeros[] = {0, 0, 0, 0, 0, 1};
+    assert(encode_base58(leading_zeros, sizeof(leading_zeros), out, sizeof(out)) == 0);
+    assert_string_equal(out, "111112");
+
+    assert(encode_base58(twos, sizeof(twos), out, 44) == EXCEPTION_OVERFLOW);
+    uint8_t too_long[65] = {0};
+    assert(encode_base58(too_long, sizeof(too_long), out, sizeof(out)) == INVALID_PARAMETER);
+}
+
+void test_encode_base58_matches_reference() {
+    uint8_t in[64];
+    uint32_t state = 0x12345678;
+
+    memset(in, 0xff, sizeof(in));
+    for (size_t length = 0; length <= sizeof(in); length++) {
+        assert_base58_matches_reference(in, length);
+    }
+
+    for (size_t round = 0; round < 64; round++) {
+        for (size_t length = 0; length <= sizeof(in); length++) {
+            for (size_t i = 0; i < length; i++) {
+                // xorshift32
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                in[i] = (uint8_t) state;
+            }
+            // Exercise leading zero bytes and zero limbs
+            size_t zeros = (round % 8) * length / 8;
+            memset(in, 0, zeros);
+            if (round % 3 == 0 && length > 8) {
+                memset(in + length / 2, 0, 4);
+            }
+            assert_base58_matches_reference(in, length);
+        }
+    }
+}
+
 int main() {
     test_print_amount();
     test_print_token_amount();
@@ -151,6 +379,9 @@ int main() {
     test_print_i64();
     test_print_u64();
     test_print_timestamp();
+    test_print_matches_reference();
+    test_encode_base58();
+    test_encode_base58_matches_reference();
 
     printf("passed\n");
     return 0;
@@ -40,21 +40,21 @@ int print_spl_associated_token_account_create_info(const SplAssociatedTokenAccou
                                                    const PrintConfig* print_config) {
     UNUSED(print_config);
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create token acct", info->address);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateTokenAcct, info->address);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From mint", info->mint);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFromMint, info->mint);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Owned by", info->owner);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleOwnedBy, info->owner);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Funded by", info->funder);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFundedBy, info->funder);
 
     /* hard-code current token account rent-exempt balance?
-    item = transaction_summary_general_item();
-    summary_item_set_amount(item, "Funded with", 2039280);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleFundedWith, 2039280);
     */
 
     return 0;
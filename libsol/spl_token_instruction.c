@@ -3,12 +3,11 @@
 #include "sol/parser.h"
 #include "sol/transaction_summary.h"
 #include "spl_token_instruction.h"
-#include "token_info.h"
 #include "util.h"
 
 const Pubkey spl_token_program_id = {{PROGRAM_ID_SPL_TOKEN}};
 
-static int parse_spl_token_instruction_kind(Parser* parser, SplTokenInstructionKind* kind) {
+int parse_spl_token_instruction_kind(Parser* parser, SplTokenInstructionKind* kind) {
     uint8_t maybe_kind;
     BAIL_IF(parse_u8(parser, &maybe_kind));
     switch (maybe_kind) {
@@ -139,8 +138,10 @@ static int parse_transfer_spl_token_instruction(Parser* parser,
     InstructionAccountsIterator it;
     instruction_accounts_iterator_init(&it, header, instruction);
 
-    BAIL_IF(parse_u64(parser, &info->body.amount));
-    BAIL_IF(parse_u8(parser, &info->body.decimals));
+    Record record;
+    BAIL_IF(parse_record(parser, sizeof(uint64_t) + sizeof(uint8_t), &record));
+    info->body.amount = record_u64(&record);
+    info->body.decimals = record_u8(&record);
 
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->src_account));
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->mint_account));
@@ -158,8 +159,10 @@ static int parse_approve_spl_token_instruction(Parser* parser,
     InstructionAccountsIterator it;
     instruction_accounts_iterator_init(&it, header, instruction);
 
-    BAIL_IF(parse_u64(parser, &info->body.amount));
-    BAIL_IF(parse_u8(parser, &info->body.decimals));
+    Record record;
+    BAIL_IF(parse_record(parser, sizeof(uint64_t) + sizeof(uint8_t), &record));
+    info->body.amount = record_u64(&record);
+    info->body.decimals = record_u8(&record);
 
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->token_account));
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->mint_account));
@@ -242,8 +245,10 @@ static int parse_mint_to_spl_token_instruction(Parser* parser,
     InstructionAccountsIterator it;
     instruction_accounts_iterator_init(&it, header, instruction);
 
-    BAIL_IF(parse_u64(parser, &info->body.amount));
-    BAIL_IF(parse_u8(parser, &info->body.decimals));
+    Record record;
+    BAIL_IF(parse_record(parser, sizeof(uint64_t) + sizeof(uint8_t), &record));
+    info->body.amount = record_u64(&record);
+    info->body.decimals = record_u8(&record);
 
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->mint_account));
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->token_account));
@@ -260,8 +265,10 @@ static int parse_burn_spl_token_instruction(Parser* parser,
     InstructionAccountsIterator it;
     instruction_accounts_iterator_init(&it, header, instruction);
 
-    BAIL_IF(parse_u64(parser, &info->body.amount));
-    BAIL_IF(parse_u8(parser, &info->body.decimals));
+    Record record;
+    BAIL_IF(parse_record(parser, sizeof(uint64_t) + sizeof(uint8_t), &record));
+    info->body.amount = record_u64(&record);
+    info->body.decimals = record_u8(&record);
 
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->token_account));
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->mint_account));
@@ -402,83 +409,122 @@ int parse_spl_token_instructions(const Instruction* instruction,
     return 1;
 }
 
+size_t spl_token_info_size(const SplTokenInfo* info) {
+    switch (info->kind) {
+        case SplTokenKind(InitializeMint):
+            return MEMBER_END(SplTokenInfo, initialize_mint);
+        case SplTokenKind(InitializeAccount):
+        case SplTokenKind(InitializeAccount2):
+            return MEMBER_END(SplTokenInfo, initialize_account);
+        case SplTokenKind(InitializeMultisig):
+            return MEMBER_END(SplTokenInfo, initialize_multisig);
+        case SplTokenKind(Revoke):
+            return MEMBER_END(SplTokenInfo, revoke);
+        case SplTokenKind(SetAuthority):
+            return MEMBER_END(SplTokenInfo, set_owner);
+        case SplTokenKind(CloseAccount):
+            return MEMBER_END(SplTokenInfo, close_account);
+        case SplTokenKind(FreezeAccount):
+            return MEMBER_END(SplTokenInfo, freeze_account);
+        case SplTokenKind(ThawAccount):
+            return MEMBER_END(SplTokenInfo, thaw_account);
+        case SplTokenKind(TransferChecked):
+            return MEMBER_END(SplTokenInfo, transfer);
+        case SplTokenKind(ApproveChecked):
+            return MEMBER_END(SplTokenInfo, approve);
+        case SplTokenKind(MintToChecked):
+            return MEMBER_END(SplTokenInfo, mint_to);
+        case SplTokenKind(BurnChecked):
+            return MEMBER_END(SplTokenInfo, burn);
+        case SplTokenKind(SyncNative):
+            return MEMBER_END(SplTokenInfo, sync_native);
+        // Deprecated instructions
+        case SplTokenKind(Transfer):
+        case SplTokenKind(Approve):
+        case SplTokenKind(MintTo):
+        case SplTokenKind(Burn):
+            break;
+    }
+    return sizeof(SplTokenInfo);
+}
+
 static int print_spl_token_sign(const SplTokenSign* sign, const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_general_item();
+    item = summary_context_general_item(print_config->summary);
     if (sign->kind == SplTokenSignKindSingle) {
         if (print_config_show_authority(print_config, sign->single.signer)) {
-            summary_item_set_pubkey(item, "Owner", sign->single.signer);
+            summary_item_set_pubkey(item, SummaryTitleOwner, sign->single.signer);
         }
     } else {
-        summary_item_set_pubkey(item, "Owner", sign->multi.account);
-        item = transaction_summary_general_item();
-        summary_item_set_u64(item, "Signers", sign->multi.signers.count);
+        summary_item_set_pubkey(item, SummaryTitleOwner, sign->multi.account);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_u64(item, SummaryTitleSigners, sign->multi.signers.count);
     }
 
     return 0;
 }
 
-static int print_spl_token_initialize_mint_info(const char* primary_title,
+static int print_spl_token_initialize_mint_info(enum SummaryTitle primary_title,
                                                 const SplTokenInitializeMintInfo* info,
                                                 const PrintConfig* print_config) {
     UNUSED(print_config);
 
     SummaryItem* item;
 
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->mint_account);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Mint authority", info->mint_authority);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleMintAuthority, info->mint_authority);
 
-    item = transaction_summary_general_item();
-    summary_item_set_u64(item, "Decimals", info->decimals);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_u64(item, SummaryTitleDecimals, info->decimals);
 
     if (info->freeze_authority != NULL) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Freeze authority", info->freeze_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFreezeAuthority, info->freeze_authority);
     }
 
     return 0;
 }
 
-static int print_spl_token_initialize_account_info(const char* primary_title,
+static int print_spl_token_initialize_account_info(enum SummaryTitle primary_title,
                                                    const SplTokenInitializeAccountInfo* info,
                                                    const PrintConfig* print_config) {
     UNUSED(print_config);
 
     SummaryItem* item;
 
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->token_account);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Owner", info->owner);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleOwner, info->owner);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Mint", info->mint_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleMint, info->mint_account);
 
     return 0;
 }
 
-static int print_spl_token_initialize_multisig_info(const char* primary_title,
+static int print_spl_token_initialize_multisig_info(enum SummaryTitle primary_title,
                                                     const SplTokenInitializeMultisigInfo* info,
                                                     const PrintConfig* print_config) {
     UNUSED(print_config);
 
     SummaryItem* item;
 
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->multisig_account);
     }
 
-    item = transaction_summary_general_item();
+    item = summary_context_general_item(print_config->summary);
     summary_item_set_multisig_m_of_n(item, info->body.m, info->signers.count);
 
     return 0;
@@ -490,23 +536,22 @@ int print_spl_token_transfer_info(const SplTokenTransferInfo* info,
     SummaryItem* item;
 
     if (primary) {
-        item = transaction_summary_primary_item();
+        item = summary_context_primary_item(print_config->summary);
     } else {
-        item = transaction_summary_general_item();
+        item = summary_context_general_item(print_config->summary);
     }
 
-    const char* symbol = get_token_symbol(info->mint_account);
     summary_item_set_token_amount(item,
-                                  "Transfer tokens",
+                                  SummaryTitleTransferTokens,
                                   info->body.amount,
-                                  symbol,
+                                  info->mint_account,
                                   info->body.decimals);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->src_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->src_account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To", info->dest_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleTo, info->dest_account);
 
     print_spl_token_sign(&info->sign, print_config);
 
@@ -517,19 +562,18 @@ static int print_spl_token_approve_info(const SplTokenApproveInfo* info,
                                         const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Approve delegate", info->delegate);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleApproveDelegate, info->delegate);
 
-    item = transaction_summary_general_item();
-    const char* symbol = get_token_symbol(info->mint_account);
+    item = summary_context_general_item(print_config->summary);
     summary_item_set_token_amount(item,
-                                  "Allowance",
+                                  SummaryTitleAllowance,
                                   info->body.amount,
-                                  symbol,
+                                  info->mint_account,
                                   info->body.decimals);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->token_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->token_account);
 
     print_spl_token_sign(&info->sign, print_config);
 
@@ -542,8 +586,8 @@ static int print_spl_token_revoke_info(const SplTokenRevokeInfo* info,
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Revoke delegate", info->token_account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleRevokeDelegate, info->token_account);
 
     print_spl_token_sign(&info->sign, print_config);
 
@@ -556,22 +600,22 @@ static int print_spl_token_set_authority_info(const SplTokenSetAuthorityInfo* in
 
     SummaryItem* item;
     bool clear_authority = info->new_authority == NULL;
-    const char* primary_title = "Set authority";
+    enum SummaryTitle primary_title = SummaryTitleSetAuthority;
     if (clear_authority) {
-        primary_title = "Clear authority";
+        primary_title = SummaryTitleClearAuthority;
     }
 
-    item = transaction_summary_primary_item();
+    item = summary_context_primary_item(print_config->summary);
     summary_item_set_pubkey(item, primary_title, info->account);
 
     const char* authority_type = stringify_token_authority_type(info->authority_type);
     BAIL_IF(authority_type == NULL);
-    item = transaction_summary_general_item();
-    summary_item_set_string(item, "Type", authority_type);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_string(item, SummaryTitleType, authority_type);
 
     if (!clear_authority) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authority", info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthority, info->new_authority);
     }
 
     print_spl_token_sign(&info->sign, print_config);
@@ -583,21 +627,20 @@ static int print_spl_token_mint_to_info(const SplTokenMintToInfo* info,
                                         const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    const char* symbol = get_token_symbol(info->mint_account);
+    item = summary_context_primary_item(print_config->summary);
     summary_item_set_token_amount(item,
-                                  "Mint tokens",
+                                  SummaryTitleMintTokens,
                                   info->body.amount,
-                                  symbol,
+                                  info->mint_account,
                                   info->body.decimals);
 
     if (print_config->expert_mode) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "From", info->mint_account);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFrom, info->mint_account);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To", info->token_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleTo, info->token_account);
 
     print_spl_token_sign(&info->sign, print_config);
 
@@ -610,16 +653,15 @@ static int print_spl_token_burn_info(const SplTokenBurnInfo* info,
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    const char* symbol = get_token_symbol(info->mint_account);
+    item = summary_context_primary_item(print_config->summary);
     summary_item_set_token_amount(item,
-                                  "Burn tokens",
+                                  SummaryTitleBurnTokens,
                                   info->body.amount,
-                                  symbol,
+                                  info->mint_account,
                                   info->body.decimals);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->token_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->token_account);
 
     print_spl_token_sign(&info->sign, print_config);
 
@@ -632,11 +674,11 @@ static int print_spl_token_close_account_info(const SplTokenCloseAccountInfo* in
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Close acct", info->token_account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCloseAcct, info->token_account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Withdraw to", info->dest_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleWithdrawTo, info->dest_account);
 
     print_spl_token_sign(&info->sign, print_config);
 
@@ -647,12 +689,12 @@ static int print_spl_token_freeze_account_info(const SplTokenFreezeAccountInfo*
                                                const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Freeze acct", info->token_account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFreezeAcct, info->token_account);
 
     if (print_config->expert_mode) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Mint", info->mint_account);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleMint, info->mint_account);
     }
 
     print_spl_token_sign(&info->sign, print_config);
@@ -664,12 +706,12 @@ static int print_spl_token_thaw_account_info(const SplTokenThawAccountInfo* info
                                              const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Thaw acct", info->token_account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleThawAcct, info->token_account);
 
     if (print_config->expert_mode) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Mint", info->mint_account);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleMint, info->mint_account);
     }
 
     print_spl_token_sign(&info->sign, print_config);
@@ -683,8 +725,8 @@ static int print_spl_token_sync_native_info(const SplTokenSyncNativeInfo* info,
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Sync native acct", info->token_account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSyncNativeAcct, info->token_account);
 
     return 0;
 }
@@ -692,16 +734,16 @@ static int print_spl_token_sync_native_info(const SplTokenSyncNativeInfo* info,
 int print_spl_token_info(const SplTokenInfo* info, const PrintConfig* print_config) {
     switch (info->kind) {
         case SplTokenKind(InitializeMint):
-            return print_spl_token_initialize_mint_info("Init mint",
+            return print_spl_token_initialize_mint_info(SummaryTitleInitMint,
                                                         &info->initialize_mint,
                                                         print_config);
         case SplTokenKind(InitializeAccount):
         case SplTokenKind(InitializeAccount2):
-            return print_spl_token_initialize_account_info("Init acct",
+            return print_spl_token_initialize_account_info(SummaryTitleInitAcct,
                                                            &info->initialize_account,
                                                            print_config);
         case SplTokenKind(InitializeMultisig):
-            return print_spl_token_initialize_multisig_info("Init multisig",
+            return print_spl_token_initialize_multisig_info(SummaryTitleInitMultisig,
                                                             &info->initialize_multisig,
                                                             print_config);
         case SplTokenKind(Revoke):
@@ -757,7 +799,7 @@ void summary_item_set_multisig_m_of_n(SummaryItem* item, uint8_t m, uint8_t n) {
     static char m_of_n[M_OF_N_MAX_LEN];
 
     if (print_m_of_n_string(m, n, m_of_n, sizeof(m_of_n)) == 0) {
-        summary_item_set_string(item, "Required signers", m_of_n);
+        summary_item_set_string(item, SummaryTitleRequiredSigners, m_of_n);
     }
 }
 
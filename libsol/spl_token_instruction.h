@@ -136,9 +136,11 @@ typedef struct SplTokenInfo {
     };
 } SplTokenInfo;
 
+int parse_spl_token_instruction_kind(Parser* parser, SplTokenInstructionKind* kind);
 int parse_spl_token_instructions(const Instruction* instruction,
                                  const MessageHeader* header,
                                  SplTokenInfo* info);
+size_t spl_token_info_size(const SplTokenInfo* info);
 int print_spl_token_info(const SplTokenInfo* info, const PrintConfig* print_config);
 void summary_item_set_multisig_m_of_n(SummaryItem* item, uint8_t m, uint8_t n);
 
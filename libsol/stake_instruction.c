@@ -9,7 +9,7 @@
 
 const Pubkey stake_program_id = {{PROGRAM_ID_STAKE}};
 
-static int parse_stake_instruction_kind(Parser* parser, enum StakeInstructionKind* kind) {
+int parse_stake_instruction_kind(Parser* parser, enum StakeInstructionKind* kind) {
     uint32_t maybe_kind;
     BAIL_IF(parse_u32(parser, &maybe_kind));
     switch (maybe_kind) {
@@ -32,9 +32,7 @@ static int parse_stake_instruction_kind(Parser* parser, enum StakeInstructionKin
     return 1;
 }
 
-static int parse_stake_authorize(Parser* parser, enum StakeAuthorize* authorize) {
-    uint32_t maybe_authorize;
-    BAIL_IF(parse_u32(parser, &maybe_authorize));
+static int stake_authorize_from_u32(uint32_t maybe_authorize, enum StakeAuthorize* authorize) {
     switch (maybe_authorize) {
         case StakeAuthorizeStaker:
         case StakeAuthorizeWithdrawer:
@@ -44,6 +42,12 @@ static int parse_stake_authorize(Parser* parser, enum StakeAuthorize* authorize)
     return 1;
 }
 
+static int parse_stake_authorize(Parser* parser, enum StakeAuthorize* authorize) {
+    uint32_t maybe_authorize;
+    BAIL_IF(parse_u32(parser, &maybe_authorize));
+    return stake_authorize_from_u32(maybe_authorize, authorize);
+}
+
 // Returns 0 and populates StakeDelegateInfo if provided a MessageHeader
 // and a delegate instruction, otherwise non-zero.
 static int parse_delegate_stake_instruction(const Instruction* instruction,
@@ -76,12 +80,17 @@ static int parse_stake_initialize_instruction(Parser* parser,
     // Skip rent sysvar
     BAIL_IF(instruction_accounts_iterator_next(&it, NULL));
 
-    BAIL_IF(parse_pubkey(parser, &info->stake_authority));
-    BAIL_IF(parse_pubkey(parser, &info->withdraw_authority));
-    // Lockup
-    BAIL_IF(parse_i64(parser, &info->lockup.unix_timestamp));
-    BAIL_IF(parse_u64(parser, &info->lockup.epoch));
-    BAIL_IF(parse_pubkey(parser, &info->lockup.custodian));
+    // Authorized + Lockup
+    Record record;
+    BAIL_IF(parse_record(parser,
+                         PUBKEY_SIZE + PUBKEY_SIZE + sizeof(int64_t) + sizeof(uint64_t) +
+                             PUBKEY_SIZE,
+                         &record));
+    info->stake_authority = record_pubkey(&record);
+    info->withdraw_authority = record_pubkey(&record);
+    info->lockup.unix_timestamp = record_i64(&record);
+    info->lockup.epoch = record_u64(&record);
+    info->lockup.custodian = record_pubkey(&record);
     info->lockup.present = StakeLockupHasAll;
 
     return 0;
@@ -142,8 +151,10 @@ static int parse_stake_authorize_instruction(Parser* parser,
     // Custodian is optional, don't BAIL_IF()
     instruction_accounts_iterator_next(&it, &info->custodian);
 
-    BAIL_IF(parse_pubkey(parser, &info->new_authority));
-    BAIL_IF(parse_stake_authorize(parser, &info->authorize));
+    Record record;
+    BAIL_IF(parse_record(parser, PUBKEY_SIZE + sizeof(uint32_t), &record));
+    info->new_authority = record_pubkey(&record);
+    BAIL_IF(stake_authorize_from_u32(record_u32(&record), &info->authorize));
 
     return 0;
 }
@@ -338,23 +349,52 @@ int parse_stake_instructions(const Instruction* instruction,
     return 1;
 }
 
-int print_delegate_stake_info(const char* primary_title,
+size_t stake_info_size(const StakeInfo* info) {
+    switch (info->kind) {
+        case StakeDelegate:
+            return MEMBER_END(StakeInfo, delegate_stake);
+        case StakeInitialize:
+        case StakeInitializeChecked:
+            return MEMBER_END(StakeInfo, initialize);
+        case StakeWithdraw:
+            return MEMBER_END(StakeInfo, withdraw);
+        case StakeAuthorize:
+        case StakeAuthorizeChecked:
+            return MEMBER_END(StakeInfo, authorize);
+        case StakeDeactivate:
+            return MEMBER_END(StakeInfo, deactivate);
+        case StakeSetLockup:
+        case StakeSetLockupChecked:
+            return MEMBER_END(StakeInfo, set_lockup);
+        case StakeSplit:
+            return MEMBER_END(StakeInfo, split);
+        case StakeMerge:
+            return MEMBER_END(StakeInfo, merge);
+        case StakeAuthorizeWithSeed:
+        case StakeAuthorizeCheckedWithSeed:
+            break;
+    }
+
+    return sizeof(StakeInfo);
+}
+
+int print_delegate_stake_info(enum SummaryTitle primary_title,
                               const StakeDelegateInfo* info,
                               const PrintConfig* print_config) {
     SummaryItem* item;
 
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->stake_pubkey);
     }
 
     if (print_config_show_authority(print_config, info->authorized_pubkey)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authorized_pubkey);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authorized_pubkey);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Vote account", info->vote_pubkey);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleVoteAccount, info->vote_pubkey);
 
     return 0;
 }
@@ -363,18 +403,18 @@ static int print_stake_withdraw_info(const StakeWithdrawInfo* info,
                                      const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_amount(item, "Stake withdraw", info->lamports);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleStakeWithdraw, info->lamports);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To", info->to);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleTo, info->to);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -382,32 +422,32 @@ static int print_stake_withdraw_info(const StakeWithdrawInfo* info,
 
 static int print_stake_authorize_info(const StakeAuthorizeInfo* info,
                                       const PrintConfig* print_config) {
-    const char* new_authority_title = NULL;
+    enum SummaryTitle new_authority_title = SummaryTitleNone;
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Set stake auth", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSetStakeAuth, info->account);
 
     switch (info->authorize) {
         case StakeAuthorizeStaker:
-            new_authority_title = "New stake auth";
+            new_authority_title = SummaryTitleNewStakeAuth;
             break;
         case StakeAuthorizeWithdrawer:
-            new_authority_title = "New withdraw auth";
+            new_authority_title = SummaryTitleNewWithdrawAuth;
             break;
     }
 
-    item = transaction_summary_general_item();
+    item = summary_context_general_item(print_config->summary);
     summary_item_set_pubkey(item, new_authority_title, info->new_authority);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     if (info->custodian && print_config_show_authority(print_config, info->custodian)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Custodian", info->custodian);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleCustodian, info->custodian);
     }
 
     return 0;
@@ -417,12 +457,12 @@ static int print_stake_deactivate_info(const StakeDeactivateInfo* info,
                                        const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Deactivate stake", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleDeactivateStake, info->account);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -432,28 +472,28 @@ static int print_stake_set_lockup_info(const StakeSetLockupInfo* info,
                                        const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Set lockup", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSetLockup, info->account);
 
     enum StakeLockupPresent present = info->lockup.present;
     if (present & StakeLockupHasTimestamp) {
-        item = transaction_summary_general_item();
-        summary_item_set_timestamp(item, "Time", info->lockup.unix_timestamp);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_timestamp(item, SummaryTitleTime, info->lockup.unix_timestamp);
     }
 
     if (present & StakeLockupHasEpoch) {
-        item = transaction_summary_general_item();
-        summary_item_set_u64(item, "Epoch", info->lockup.epoch);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_u64(item, SummaryTitleEpoch, info->lockup.epoch);
     }
 
     if (present & StakeLockupHasCustodian) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New authority", info->lockup.custodian);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewAuthority, info->lockup.custodian);
     }
 
     if (print_config_show_authority(print_config, info->custodian)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->custodian);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->custodian);
     }
 
     return 0;
@@ -467,15 +507,15 @@ static int print_stake_split_info(const StakeSplitInfo* info, const PrintConfig*
 static int print_stake_merge_info(const StakeMergeInfo* info, const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Merge", info->source);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleMerge, info->source);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Into", info->destination);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleInto, info->destination);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -484,10 +524,14 @@ static int print_stake_merge_info(const StakeMergeInfo* info, const PrintConfig*
 int print_stake_info(const StakeInfo* info, const PrintConfig* print_config) {
     switch (info->kind) {
         case StakeDelegate:
-            return print_delegate_stake_info("Delegate from", &info->delegate_stake, print_config);
+            return print_delegate_stake_info(SummaryTitleDelegateFrom,
+                                             &info->delegate_stake,
+                                             print_config);
         case StakeInitialize:
         case StakeInitializeChecked:
-            return print_stake_initialize_info("Init stake acct", &info->initialize, print_config);
+            return print_stake_initialize_info(SummaryTitleInitStakeAcct,
+                                               &info->initialize,
+                                               print_config);
         case StakeWithdraw:
             return print_stake_withdraw_info(&info->withdraw, print_config);
         case StakeAuthorize:
@@ -511,46 +555,46 @@ int print_stake_info(const StakeInfo* info, const PrintConfig* print_config) {
     return 1;
 }
 
-int print_stake_initialize_info(const char* primary_title,
+int print_stake_initialize_info(enum SummaryTitle primary_title,
                                 const StakeInitializeInfo* info,
                                 const PrintConfig* print_config) {
     SummaryItem* item;
     bool one_authority = pubkeys_equal(info->withdraw_authority, info->stake_authority);
 
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->account);
     }
 
     if (one_authority) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New authority", info->stake_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewAuthority, info->stake_authority);
     } else {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New stake auth", info->stake_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewStakeAuth, info->stake_authority);
 
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New withdraw auth", info->withdraw_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewWithdrawAuth, info->withdraw_authority);
     }
 
     int64_t lockup_time = info->lockup.unix_timestamp;
     uint64_t lockup_epoch = info->lockup.epoch;
     if (lockup_time > 0 || lockup_epoch > 0) {
         if (lockup_time > 0) {
-            item = transaction_summary_general_item();
-            summary_item_set_timestamp(item, "Lockup time", lockup_time);
+            item = summary_context_general_item(print_config->summary);
+            summary_item_set_timestamp(item, SummaryTitleLockupTime, lockup_time);
         }
 
         if (lockup_epoch > 0) {
-            item = transaction_summary_general_item();
-            summary_item_set_u64(item, "Lockup epoch", lockup_epoch);
+            item = summary_context_general_item(print_config->summary);
+            summary_item_set_u64(item, SummaryTitleLockupEpoch, lockup_epoch);
         }
 
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Lockup authority", info->lockup.custodian);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleLockupAuthority, info->lockup.custodian);
     } else if (print_config->expert_mode) {
-        item = transaction_summary_general_item();
-        summary_item_set_string(item, "Lockup", "None");
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_string(item, SummaryTitleLockup, "None");
     }
 
     return 0;
@@ -561,14 +605,14 @@ int print_stake_split_info1(const StakeSplitInfo* info, const PrintConfig* print
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_amount(item, "Split stake", info->lamports);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleSplitStake, info->lamports);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To", info->split_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleTo, info->split_account);
 
     return 0;
 }
@@ -577,8 +621,8 @@ int print_stake_split_info2(const StakeSplitInfo* info, const PrintConfig* print
     if (print_config_show_authority(print_config, info->authority)) {
         SummaryItem* item;
 
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -110,12 +110,14 @@ typedef struct StakeInfo {
     };
 } StakeInfo;
 
+int parse_stake_instruction_kind(Parser* parser, enum StakeInstructionKind* kind);
 int parse_stake_instructions(const Instruction* instruction,
                              const MessageHeader* header,
                              StakeInfo* info);
+size_t stake_info_size(const StakeInfo* info);
 int print_stake_info(const StakeInfo* info, const PrintConfig* print_config);
 
-int print_stake_initialize_info(const char* primary_title,
+int print_stake_initialize_info(enum SummaryTitle primary_title,
                                 const StakeInitializeInfo* info,
                                 const PrintConfig* print_config);
 
@@ -123,6 +125,6 @@ int print_stake_split_info1(const StakeSplitInfo* info, const PrintConfig* print
 
 int print_stake_split_info2(const StakeSplitInfo* info, const PrintConfig* print_config);
 
-int print_delegate_stake_info(const char* primary_title,
+int print_delegate_stake_info(enum SummaryTitle primary_title,
                               const StakeDelegateInfo* info,
                               const PrintConfig* print_config);
@@ -6,11 +6,11 @@
 #include "util.h"
 #include <string.h>
 
-#define CREATE_ACCOUNT_TITLE "Create account"
+#define CREATE_ACCOUNT_TITLE SummaryTitleCreateAccount
 
 const Pubkey system_program_id = {{PROGRAM_ID_SYSTEM}};
 
-static int parse_system_instruction_kind(Parser* parser, enum SystemInstructionKind* kind) {
+int parse_system_instruction_kind(Parser* parser, enum SystemInstructionKind* kind) {
     uint32_t maybe_kind;
     BAIL_IF(parse_u32(parser, &maybe_kind));
     switch (maybe_kind) {
@@ -255,20 +255,49 @@ int parse_system_instructions(const Instruction* instruction,
     return 1;
 }
 
+size_t system_info_size(const SystemInfo* info) {
+    switch (info->kind) {
+        case SystemTransfer:
+            return MEMBER_END(SystemInfo, transfer);
+        case SystemAdvanceNonceAccount:
+            return MEMBER_END(SystemInfo, advance_nonce);
+        case SystemCreateAccount:
+            return MEMBER_END(SystemInfo, create_account);
+        case SystemCreateAccountWithSeed:
+            return MEMBER_END(SystemInfo, create_account_with_seed);
+        case SystemInitializeNonceAccount:
+            return MEMBER_END(SystemInfo, initialize_nonce);
+        case SystemWithdrawNonceAccount:
+            return MEMBER_END(SystemInfo, withdraw_nonce);
+        case SystemAuthorizeNonceAccount:
+            return MEMBER_END(SystemInfo, authorize_nonce);
+        case SystemAssign:
+            return MEMBER_END(SystemInfo, assign);
+        case SystemAllocate:
+            return MEMBER_END(SystemInfo, allocate);
+        case SystemAllocateWithSeed:
+            return MEMBER_END(SystemInfo, allocate_with_seed);
+        case SystemAssignWithSeed:
+            break;
+    }
+
+    return sizeof(SystemInfo);
+}
+
 static int print_system_transfer_info(const SystemTransferInfo* info,
                                       const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_amount(item, "Transfer", info->lamports);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleTransfer, info->lamports);
 
     if (print_config_show_authority(print_config, info->from)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Sender", info->from);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleSender, info->from);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Recipient", info->to);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleRecipient, info->to);
 
     return 0;
 }
@@ -277,12 +306,12 @@ static int print_system_advance_nonce_account(const SystemAdvanceNonceInfo* info
                                               const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Advance nonce", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleAdvanceNonce, info->account);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -292,18 +321,18 @@ static int print_system_withdraw_nonce_info(const SystemWithdrawNonceInfo* info,
                                             const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_amount(item, "Nonce withdraw", info->lamports);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleNonceWithdraw, info->lamports);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To", info->to);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleTo, info->to);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -313,15 +342,15 @@ static int print_system_authorize_nonce_info(const SystemAuthorizeNonceInfo* inf
                                              const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Set nonce auth", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSetNonceAuth, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "New authority", info->new_authority);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleNewAuthority, info->new_authority);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -333,11 +362,11 @@ static int print_system_allocate_info(const SystemAllocateInfo* info,
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Allocate acct", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleAllocateAcct, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_u64(item, "Data size", info->space);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_u64(item, SummaryTitleDataSize, info->space);
 
     return 0;
 }
@@ -347,11 +376,11 @@ static int print_system_assign_info(const SystemAssignInfo* info, const PrintCon
 
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Assign acct", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleAssignAcct, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To program", info->program_id);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleToProgram, info->program_id);
 
     return 0;
 }
@@ -371,7 +400,7 @@ int print_system_info(const SystemInfo* info, const PrintConfig* print_config) {
                                                               &info->create_account_with_seed,
                                                               print_config);
         case SystemInitializeNonceAccount:
-            return print_system_initialize_nonce_info("Init nonce acct",
+            return print_system_initialize_nonce_info(SummaryTitleInitNonceAcct,
                                                       &info->initialize_nonce,
                                                       print_config);
         case SystemWithdrawNonceAccount:
@@ -383,7 +412,7 @@ int print_system_info(const SystemInfo* info, const PrintConfig* print_config) {
         case SystemAllocate:
             return print_system_allocate_info(&info->allocate, print_config);
         case SystemAllocateWithSeed:
-            return print_system_allocate_with_seed_info("Allocate acct",
+            return print_system_allocate_with_seed_info(SummaryTitleAllocateAcct,
                                                         &info->allocate_with_seed,
                                                         print_config);
         case SystemAssignWithSeed:
@@ -399,100 +428,100 @@ int print_system_nonced_transaction_sentinel(const SystemInfo* info,
         const SystemAdvanceNonceInfo* nonce_info = &info->advance_nonce;
         SummaryItem* item;
 
-        item = transaction_summary_nonce_account_item();
-        summary_item_set_pubkey(item, "Nonce account", nonce_info->account);
+        item = summary_context_nonce_account_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNonceAccount, nonce_info->account);
 
-        item = transaction_summary_nonce_authority_item();
-        summary_item_set_pubkey(item, "Nonce authority", nonce_info->authority);
+        item = summary_context_nonce_authority_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNonceAuthority, nonce_info->authority);
     }
 
     return 0;
 }
 
-int print_system_create_account_info(const char* primary_title,
+int print_system_create_account_info(enum SummaryTitle primary_title,
                                      const SystemCreateAccountInfo* info,
                                      const PrintConfig* print_config) {
     SummaryItem* item;
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->to);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_amount(item, "Deposit", info->lamports);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleDeposit, info->lamports);
 
     if (print_config_show_authority(print_config, info->from)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "From", info->from);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFrom, info->from);
     }
 
     return 0;
 }
 
-int print_system_create_account_with_seed_info(const char* primary_title,
+int print_system_create_account_with_seed_info(enum SummaryTitle primary_title,
                                                const SystemCreateAccountWithSeedInfo* info,
                                                const PrintConfig* print_config) {
     SummaryItem* item;
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->to);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_amount(item, "Deposit", info->lamports);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleDeposit, info->lamports);
 
     if (print_config_show_authority(print_config, info->from)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "From", info->from);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFrom, info->from);
     }
 
     if (print_config->expert_mode) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Base", info->base);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleBase, info->base);
 
-        item = transaction_summary_general_item();
-        summary_item_set_sized_string(item, "Seed", &info->seed);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_sized_string(item, SummaryTitleSeed, &info->seed);
     }
 
     return 0;
 }
 
-int print_system_initialize_nonce_info(const char* primary_title,
+int print_system_initialize_nonce_info(enum SummaryTitle primary_title,
                                        const SystemInitializeNonceInfo* info,
                                        const PrintConfig* print_config) {
     UNUSED(print_config);
 
     SummaryItem* item;
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->account);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "New authority", info->authority);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleNewAuthority, info->authority);
 
     return 0;
 }
 
-int print_system_allocate_with_seed_info(const char* primary_title,
+int print_system_allocate_with_seed_info(enum SummaryTitle primary_title,
                                          const SystemAllocateWithSeedInfo* info,
                                          const PrintConfig* print_config) {
     SummaryItem* item;
 
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
-        summary_item_set_pubkey(item, "Allocate acct", info->account);
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAllocateAcct, info->account);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_u64(item, "Data size", info->space);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_u64(item, SummaryTitleDataSize, info->space);
 
     if (print_config->expert_mode) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Base", info->base);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleBase, info->base);
 
-        item = transaction_summary_general_item();
-        summary_item_set_sized_string(item, "Seed", &info->seed);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_sized_string(item, SummaryTitleSeed, &info->seed);
     }
 
     return 0;
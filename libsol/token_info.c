@@ -11,13 +11,22 @@ const struct token_info token_infos[] = {
     {&spl_token_program_id, "WSOL"},
 };
 
-const char* get_token_symbol(const Pubkey* mint_address) {
+_Static_assert(ARRAY_LEN(token_infos) < TOKEN_INDEX_UNKNOWN, "Too many known tokens");
+
+uint8_t get_token_index(const Pubkey* mint_address) {
     size_t i;
     for (i = 0; i < ARRAY_LEN(token_infos); i++) {
         const struct token_info* ti = &token_infos[i];
         if (memcmp(ti->mint_address, mint_address, PUBKEY_SIZE) == 0) {
-            return ti->symbol;
+            return i;
         }
     }
+    return TOKEN_INDEX_UNKNOWN;
+}
+
+const char* get_token_symbol(uint8_t token_index) {
+    if (token_index < ARRAY_LEN(token_infos)) {
+        return token_infos[token_index].symbol;
+    }
     return "???";
 }
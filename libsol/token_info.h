@@ -2,4 +2,9 @@
 
 #include "sol/parser.h"
 
-const char* get_token_symbol(const Pubkey* mint_address);
+#define TOKEN_INDEX_UNKNOWN UINT8_MAX
+
+// Index of the token of `mint_address` among the known tokens, so that it
+// fits a byte. TOKEN_INDEX_UNKNOWN if the token is not known
+uint8_t get_token_index(const Pubkey* mint_address);
+const char* get_token_symbol(uint8_t token_index);
@@ -5,180 +5,95 @@
 #include "transaction_printers.h"
 #include "util.h"
 
-const InstructionBrief nonce_brief[] = {
-    SYSTEM_IX_BRIEF(SystemAdvanceNonceAccount),
+#define SPL_ASSOCIATED_TOKEN_ACCOUNT_IX INSTRUCTION_CODE(ProgramIdSplAssociatedTokenAccount, 0)
+#define SPL_TOKEN_IX(spl_token_ix) INSTRUCTION_CODE(ProgramIdSplToken, spl_token_ix)
+#define SYSTEM_IX(system_ix) INSTRUCTION_CODE(ProgramIdSystem, system_ix)
+#define STAKE_IX(stake_ix) INSTRUCTION_CODE(ProgramIdStake, stake_ix)
+#define VOTE_IX(vote_ix) INSTRUCTION_CODE(ProgramIdVote, vote_ix)
+
+// Signature of a multi-instruction message, see instruction_infos_signature()
+#define SIGNATURE2(ix0, ix1) ((uint32_t) (ix0) | (uint32_t) (ix1) << 8)
+#define SIGNATURE3(ix0, ix1, ix2) (SIGNATURE2(ix0, ix1) | (uint32_t) (ix2) << 16)
+
+#define is_advance_nonce_account(info) \
+    (instruction_info_code(info) == SYSTEM_IX(SystemAdvanceNonceAccount))
+
+enum TransactionPrinter {
+    PrintCreateStakeAccount,
+    PrintCreateStakeAccountWithSeed,
+    PrintCreateStakeAccountAndDelegate,
+    PrintCreateStakeAccountWithSeedAndDelegate,
+    PrintStakeSplitV1_1,
+    PrintStakeSplitWithSeedV1_1,
+    PrintStakeSplitV1_2,
+    PrintStakeSplitWithSeedV1_2,
+    PrintStakeAuthorizeBoth,
+    PrintCreateNonceAccount,
+    PrintCreateNonceAccountWithSeed,
+    PrintCreateVoteAccount,
+    PrintCreateVoteAccountWithSeed,
+    PrintVoteAuthorizeBoth,
+    PrintSplTokenCreateMint,
+    PrintSplTokenCreateAccount,
+    PrintSplTokenCreateMultisig,
+    PrintSplAssociatedTokenAccountCreateWithTransfer,
 };
-#define is_advance_nonce_account(infos) instruction_info_matches_brief(infos, nonce_brief)
 
-const InstructionBrief create_stake_account_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    STAKE_IX_BRIEF(StakeInitialize),
+typedef struct TransactionPattern {
+    uint32_t signature;
+    enum TransactionPrinter printer;
+} TransactionPattern;
+
+// Multi-instruction messages with a dedicated summary, sorted by signature so
+// that a message is matched with a binary search
+static const TransactionPattern transaction_patterns[] = {
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), STAKE_IX(StakeInitialize)),
+     PrintCreateStakeAccount},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccountWithSeed), STAKE_IX(StakeInitialize)),
+     PrintCreateStakeAccountWithSeed},
+    {SIGNATURE2(STAKE_IX(StakeAuthorize), STAKE_IX(StakeAuthorize)), PrintStakeAuthorizeBoth},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), STAKE_IX(StakeSplit)), PrintStakeSplitV1_2},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccountWithSeed), STAKE_IX(StakeSplit)),
+     PrintStakeSplitWithSeedV1_2},
+    {SIGNATURE2(SYSTEM_IX(SystemAllocateWithSeed), STAKE_IX(StakeSplit)),
+     PrintStakeSplitWithSeedV1_1},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), STAKE_IX(StakeInitializeChecked)),
+     PrintCreateStakeAccount},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccountWithSeed), STAKE_IX(StakeInitializeChecked)),
+     PrintCreateStakeAccountWithSeed},
+    {SIGNATURE2(STAKE_IX(StakeAuthorizeChecked), STAKE_IX(StakeAuthorizeChecked)),
+     PrintStakeAuthorizeBoth},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), SYSTEM_IX(SystemInitializeNonceAccount)),
+     PrintCreateNonceAccount},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccountWithSeed), SYSTEM_IX(SystemInitializeNonceAccount)),
+     PrintCreateNonceAccountWithSeed},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), VOTE_IX(VoteInitialize)), PrintCreateVoteAccount},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccountWithSeed), VOTE_IX(VoteInitialize)),
+     PrintCreateVoteAccountWithSeed},
+    {SIGNATURE2(VOTE_IX(VoteAuthorize), VOTE_IX(VoteAuthorize)), PrintVoteAuthorizeBoth},
+    {SIGNATURE2(VOTE_IX(VoteAuthorizeChecked), VOTE_IX(VoteAuthorizeChecked)),
+     PrintVoteAuthorizeBoth},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), SPL_TOKEN_IX(SplTokenKind(InitializeMint))),
+     PrintSplTokenCreateMint},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), SPL_TOKEN_IX(SplTokenKind(InitializeAccount))),
+     PrintSplTokenCreateAccount},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), SPL_TOKEN_IX(SplTokenKind(InitializeMultisig))),
+     PrintSplTokenCreateMultisig},
+    {SIGNATURE2(SPL_ASSOCIATED_TOKEN_ACCOUNT_IX, SPL_TOKEN_IX(SplTokenKind(TransferChecked))),
+     PrintSplAssociatedTokenAccountCreateWithTransfer},
+    {SIGNATURE2(SYSTEM_IX(SystemCreateAccount), SPL_TOKEN_IX(SplTokenKind(InitializeAccount2))),
+     PrintSplTokenCreateAccount},
+    {SIGNATURE3(SYSTEM_IX(SystemCreateAccount),
+                STAKE_IX(StakeInitialize),
+                STAKE_IX(StakeDelegate)),
+     PrintCreateStakeAccountAndDelegate},
+    {SIGNATURE3(SYSTEM_IX(SystemCreateAccountWithSeed),
+                STAKE_IX(StakeInitialize),
+                STAKE_IX(StakeDelegate)),
+     PrintCreateStakeAccountWithSeedAndDelegate},
+    {SIGNATURE3(SYSTEM_IX(SystemAllocate), SYSTEM_IX(SystemAssign), STAKE_IX(StakeSplit)),
+     PrintStakeSplitV1_1},
 };
-#define is_create_stake_account(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_stake_account_brief, infos_length)
-
-const InstructionBrief create_stake_account_checked_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    STAKE_IX_BRIEF(StakeInitializeChecked),
-};
-#define is_create_stake_account_checked(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_stake_account_checked_brief, infos_length)
-
-const InstructionBrief create_stake_account_with_seed_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccountWithSeed),
-    STAKE_IX_BRIEF(StakeInitialize),
-};
-#define is_create_stake_account_with_seed(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_stake_account_with_seed_brief, infos_length)
-
-const InstructionBrief create_stake_account_with_seed_checked_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccountWithSeed),
-    STAKE_IX_BRIEF(StakeInitializeChecked),
-};
-#define is_create_stake_account_with_seed_checked(infos, infos_length)           \
-    instruction_infos_match_briefs(infos,                                        \
-                                   create_stake_account_with_seed_checked_brief, \
-                                   infos_length)
-
-const InstructionBrief create_stake_account_and_delegate_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    STAKE_IX_BRIEF(StakeInitialize),
-    STAKE_IX_BRIEF(StakeDelegate),
-};
-#define is_create_stake_account_and_delegate(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_stake_account_and_delegate_brief, infos_length)
-
-const InstructionBrief create_stake_account_with_seed_and_delegate_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccountWithSeed),
-    STAKE_IX_BRIEF(StakeInitialize),
-    STAKE_IX_BRIEF(StakeDelegate),
-};
-#define is_create_stake_account_with_seed_and_delegate(infos, infos_length)           \
-    instruction_infos_match_briefs(infos,                                             \
-                                   create_stake_account_with_seed_and_delegate_brief, \
-                                   infos_length)
-
-const InstructionBrief stake_split_brief_v1_1[] = {
-    SYSTEM_IX_BRIEF(SystemAllocate),
-    SYSTEM_IX_BRIEF(SystemAssign),
-    STAKE_IX_BRIEF(StakeSplit),
-};
-#define is_stake_split_v1_1(infos, infos_length) \
-    instruction_infos_match_briefs(infos, stake_split_brief_v1_1, infos_length)
-
-const InstructionBrief stake_split_with_seed_brief_v1_1[] = {
-    SYSTEM_IX_BRIEF(SystemAllocateWithSeed),
-    STAKE_IX_BRIEF(StakeSplit),
-};
-#define is_stake_split_with_seed_v1_1(infos, infos_length) \
-    instruction_infos_match_briefs(infos, stake_split_with_seed_brief_v1_1, infos_length)
-
-const InstructionBrief stake_split_brief_v1_2[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    STAKE_IX_BRIEF(StakeSplit),
-};
-#define is_stake_split_v1_2(infos, infos_length) \
-    instruction_infos_match_briefs(infos, stake_split_brief_v1_2, infos_length)
-
-const InstructionBrief stake_split_with_seed_brief_v1_2[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccountWithSeed),
-    STAKE_IX_BRIEF(StakeSplit),
-};
-#define is_stake_split_with_seed_v1_2(infos, infos_length) \
-    instruction_infos_match_briefs(infos, stake_split_with_seed_brief_v1_2, infos_length)
-
-const InstructionBrief stake_authorize_both_brief[] = {
-    STAKE_IX_BRIEF(StakeAuthorize),
-    STAKE_IX_BRIEF(StakeAuthorize),
-};
-#define is_stake_authorize_both(infos, infos_length) \
-    instruction_infos_match_briefs(infos, stake_authorize_both_brief, infos_length)
-
-const InstructionBrief stake_authorize_checked_both_brief[] = {
-    STAKE_IX_BRIEF(StakeAuthorizeChecked),
-    STAKE_IX_BRIEF(StakeAuthorizeChecked),
-};
-#define is_stake_authorize_checked_both(infos, infos_length) \
-    instruction_infos_match_briefs(infos, stake_authorize_checked_both_brief, infos_length)
-
-const InstructionBrief create_nonce_account_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    SYSTEM_IX_BRIEF(SystemInitializeNonceAccount),
-};
-#define is_create_nonce_account(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_nonce_account_brief, infos_length)
-
-const InstructionBrief create_nonce_account_with_seed_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccountWithSeed),
-    SYSTEM_IX_BRIEF(SystemInitializeNonceAccount),
-};
-#define is_create_nonce_account_with_seed(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_nonce_account_with_seed_brief, infos_length)
-
-const InstructionBrief create_vote_account_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    VOTE_IX_BRIEF(VoteInitialize),
-};
-#define is_create_vote_account(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_vote_account_brief, infos_length)
-
-const InstructionBrief create_vote_account_with_seed_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccountWithSeed),
-    VOTE_IX_BRIEF(VoteInitialize),
-};
-#define is_create_vote_account_with_seed(infos, infos_length) \
-    instruction_infos_match_briefs(infos, create_vote_account_with_seed_brief, infos_length)
-
-const InstructionBrief vote_authorize_both_brief[] = {
-    VOTE_IX_BRIEF(VoteAuthorize),
-    VOTE_IX_BRIEF(VoteAuthorize),
-};
-#define is_vote_authorize_both(infos, infos_length) \
-    instruction_infos_match_briefs(infos, vote_authorize_both_brief, infos_length)
-
-const InstructionBrief vote_authorize_checked_both_brief[] = {
-    VOTE_IX_BRIEF(VoteAuthorizeChecked),
-    VOTE_IX_BRIEF(VoteAuthorizeChecked),
-};
-#define is_vote_authorize_checked_both(infos, infos_length) \
-    instruction_infos_match_briefs(infos, vote_authorize_checked_both_brief, infos_length)
-
-const InstructionBrief spl_token_create_mint_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    SPL_TOKEN_IX_BRIEF(SplTokenKind(InitializeMint)),
-};
-#define is_spl_token_create_mint(infos, infos_length) \
-    instruction_infos_match_briefs(infos, spl_token_create_mint_brief, infos_length)
-
-const InstructionBrief spl_token_create_account_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    SPL_TOKEN_IX_BRIEF(SplTokenKind(InitializeAccount)),
-};
-#define is_spl_token_create_account(infos, infos_length) \
-    instruction_infos_match_briefs(infos, spl_token_create_account_brief, infos_length)
-
-const InstructionBrief spl_token_create_account2_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    SPL_TOKEN_IX_BRIEF(SplTokenKind(InitializeAccount2)),
-};
-#define is_spl_token_create_account2(infos, infos_length) \
-    instruction_infos_match_briefs(infos, spl_token_create_account2_brief, infos_length)
-
-const InstructionBrief spl_token_create_multisig_brief[] = {
-    SYSTEM_IX_BRIEF(SystemCreateAccount),
-    SPL_TOKEN_IX_BRIEF(SplTokenKind(InitializeMultisig)),
-};
-#define is_spl_token_create_multisig(infos, infos_length) \
-    instruction_infos_match_briefs(infos, spl_token_create_multisig_brief, infos_length)
-
-const InstructionBrief spl_associated_token_account_create_with_transfer_brief[] = {
-    SPL_ASSOCIATED_TOKEN_ACCOUNT_IX_BRIEF,
-    SPL_TOKEN_IX_BRIEF(SplTokenKind(TransferChecked)),
-};
-#define is_spl_associated_token_account_create_with_transfer(infos, infos_length)           \
-    instruction_infos_match_briefs(infos,                                                   \
-                                   spl_associated_token_account_create_with_transfer_brief, \
-                                   infos_length)
 
 static int print_create_stake_account(const PrintConfig* print_config,
                                       InstructionInfo* const* infos,
@@ -188,11 +103,11 @@ static int print_create_stake_account(const PrintConfig* print_config,
     const SystemCreateAccountInfo* ca_info = &infos[0]->system.create_account;
     const StakeInitializeInfo* si_info = &infos[1]->stake.initialize;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create stake acct", ca_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateStakeAcct, ca_info->to);
 
-    BAIL_IF(print_system_create_account_info(NULL, ca_info, print_config));
-    BAIL_IF(print_stake_initialize_info(NULL, si_info, print_config));
+    BAIL_IF(print_system_create_account_info(SummaryTitleNone, ca_info, print_config));
+    BAIL_IF(print_stake_initialize_info(SummaryTitleNone, si_info, print_config));
 
     return 0;
 }
@@ -205,11 +120,11 @@ static int print_create_stake_account_with_seed(const PrintConfig* print_config,
     const SystemCreateAccountWithSeedInfo* cws_info = &infos[0]->system.create_account_with_seed;
     const StakeInitializeInfo* si_info = &infos[1]->stake.initialize;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create stake acct", cws_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateStakeAcct, cws_info->to);
 
-    BAIL_IF(print_system_create_account_with_seed_info(NULL, cws_info, print_config));
-    BAIL_IF(print_stake_initialize_info(NULL, si_info, print_config));
+    BAIL_IF(print_system_create_account_with_seed_info(SummaryTitleNone, cws_info, print_config));
+    BAIL_IF(print_stake_initialize_info(SummaryTitleNone, si_info, print_config));
 
     return 0;
 }
@@ -223,12 +138,12 @@ static int print_create_stake_account_and_delegate(const PrintConfig* print_conf
     const StakeInitializeInfo* si_info = &infos[1]->stake.initialize;
     const StakeDelegateInfo* sd_info = &infos[2]->stake.delegate_stake;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Delegate from", ca_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleDelegateFrom, ca_info->to);
 
-    BAIL_IF(print_system_create_account_info(NULL, ca_info, print_config));
-    BAIL_IF(print_stake_initialize_info(NULL, si_info, print_config));
-    BAIL_IF(print_delegate_stake_info(NULL, sd_info, print_config));
+    BAIL_IF(print_system_create_account_info(SummaryTitleNone, ca_info, print_config));
+    BAIL_IF(print_stake_initialize_info(SummaryTitleNone, si_info, print_config));
+    BAIL_IF(print_delegate_stake_info(SummaryTitleNone, sd_info, print_config));
 
     return 0;
 }
@@ -242,12 +157,12 @@ static int print_create_stake_account_with_seed_and_delegate(const PrintConfig*
     const StakeInitializeInfo* si_info = &infos[1]->stake.initialize;
     const StakeDelegateInfo* sd_info = &infos[2]->stake.delegate_stake;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Delegate from", cws_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleDelegateFrom, cws_info->to);
 
-    BAIL_IF(print_system_create_account_with_seed_info(NULL, cws_info, print_config));
-    BAIL_IF(print_stake_initialize_info(NULL, si_info, print_config));
-    BAIL_IF(print_delegate_stake_info(NULL, sd_info, print_config));
+    BAIL_IF(print_system_create_account_with_seed_info(SummaryTitleNone, cws_info, print_config));
+    BAIL_IF(print_stake_initialize_info(SummaryTitleNone, si_info, print_config));
+    BAIL_IF(print_delegate_stake_info(SummaryTitleNone, sd_info, print_config));
 
     return 0;
 }
@@ -277,10 +192,10 @@ static int print_stake_split_with_seed(const PrintConfig* print_config,
     BAIL_IF(print_stake_split_info1(ss_info, print_config));
 
     if (print_config->expert_mode) {
-        SummaryItem* item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Base", base);
-        item = transaction_summary_general_item();
-        summary_item_set_sized_string(item, "Seed", seed);
+        SummaryItem* item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleBase, base);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_sized_string(item, SummaryTitleSeed, seed);
     }
 
     BAIL_IF(print_stake_split_info2(ss_info, print_config));
@@ -301,28 +216,28 @@ static int print_stake_authorize_both(const PrintConfig* print_config,
     BAIL_IF(staker_info->authorize != StakeAuthorizeStaker);
     BAIL_IF(withdrawer_info->authorize != StakeAuthorizeWithdrawer);
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Set stake auth", staker_info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSetStakeAuth, staker_info->account);
 
     if (staker_info->new_authority == withdrawer_info->new_authority) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New authorities", staker_info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewAuthorities, staker_info->new_authority);
     } else {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New stake auth", staker_info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewStakeAuth, staker_info->new_authority);
 
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New withdraw auth", withdrawer_info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewWithdrawAuth, withdrawer_info->new_authority);
     }
 
     if (withdrawer_info->custodian) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Custodian", withdrawer_info->custodian);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleCustodian, withdrawer_info->custodian);
     }
 
     if (print_config_show_authority(print_config, withdrawer_info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", withdrawer_info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, withdrawer_info->authority);
     }
 
     return 0;
@@ -336,11 +251,11 @@ static int print_create_nonce_account(const PrintConfig* print_config,
     const SystemCreateAccountInfo* ca_info = &infos[0]->system.create_account;
     const SystemInitializeNonceInfo* ni_info = &infos[1]->system.initialize_nonce;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create nonce acct", ca_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateNonceAcct, ca_info->to);
 
-    BAIL_IF(print_system_create_account_info(NULL, ca_info, print_config));
-    BAIL_IF(print_system_initialize_nonce_info(NULL, ni_info, print_config));
+    BAIL_IF(print_system_create_account_info(SummaryTitleNone, ca_info, print_config));
+    BAIL_IF(print_system_initialize_nonce_info(SummaryTitleNone, ni_info, print_config));
 
     return 0;
 }
@@ -353,11 +268,11 @@ static int print_create_nonce_account_with_seed(const PrintConfig* print_config,
     const SystemCreateAccountWithSeedInfo* ca_info = &infos[0]->system.create_account_with_seed;
     const SystemInitializeNonceInfo* ni_info = &infos[1]->system.initialize_nonce;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create nonce acct", ca_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateNonceAcct, ca_info->to);
 
-    BAIL_IF(print_system_create_account_with_seed_info(NULL, ca_info, print_config));
-    BAIL_IF(print_system_initialize_nonce_info(NULL, ni_info, print_config));
+    BAIL_IF(print_system_create_account_with_seed_info(SummaryTitleNone, ca_info, print_config));
+    BAIL_IF(print_system_initialize_nonce_info(SummaryTitleNone, ni_info, print_config));
 
     return 0;
 }
@@ -370,11 +285,11 @@ static int print_create_vote_account(const PrintConfig* print_config,
     const SystemCreateAccountInfo* ca_info = &infos[0]->system.create_account;
     const VoteInitializeInfo* vi_info = &infos[1]->vote.initialize;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create vote acct", ca_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateVoteAcct, ca_info->to);
 
-    BAIL_IF(print_system_create_account_info(NULL, ca_info, print_config));
-    BAIL_IF(print_vote_initialize_info(NULL, vi_info, print_config));
+    BAIL_IF(print_system_create_account_info(SummaryTitleNone, ca_info, print_config));
+    BAIL_IF(print_vote_initialize_info(SummaryTitleNone, vi_info, print_config));
 
     return 0;
 }
@@ -387,11 +302,11 @@ static int print_create_vote_account_with_seed(const PrintConfig* print_config,
     const SystemCreateAccountWithSeedInfo* ca_info = &infos[0]->system.create_account_with_seed;
     const VoteInitializeInfo* vi_info = &infos[1]->vote.initialize;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create vote acct", ca_info->to);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateVoteAcct, ca_info->to);
 
-    BAIL_IF(print_system_create_account_with_seed_info(NULL, ca_info, print_config));
-    BAIL_IF(print_vote_initialize_info(NULL, vi_info, print_config));
+    BAIL_IF(print_system_create_account_with_seed_info(SummaryTitleNone, ca_info, print_config));
+    BAIL_IF(print_vote_initialize_info(SummaryTitleNone, vi_info, print_config));
 
     return 0;
 }
@@ -409,23 +324,23 @@ static int print_vote_authorize_both(const PrintConfig* print_config,
     BAIL_IF(voter_info->authorize != VoteAuthorizeVoter);
     BAIL_IF(withdrawer_info->authorize != VoteAuthorizeWithdrawer);
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Set vote auth", voter_info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSetVoteAuth, voter_info->account);
 
     if (voter_info->new_authority == withdrawer_info->new_authority) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New authorities", voter_info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewAuthorities, voter_info->new_authority);
     } else {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New vote auth", voter_info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewVoteAuth, voter_info->new_authority);
 
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "New withdraw auth", withdrawer_info->new_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleNewWithdrawAuth, withdrawer_info->new_authority);
     }
 
     if (print_config_show_authority(print_config, withdrawer_info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", withdrawer_info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, withdrawer_info->authority);
     }
 
     return 0;
@@ -439,27 +354,27 @@ static int print_spl_token_create_mint(const PrintConfig* print_config,
     const SystemCreateAccountInfo* ca_info = &infos[0]->system.create_account;
     const SplTokenInitializeMintInfo* im_info = &infos[1]->spl_token.initialize_mint;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create token mint", im_info->mint_account);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateTokenMint, im_info->mint_account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Mint authority", im_info->mint_authority);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleMintAuthority, im_info->mint_authority);
 
-    item = transaction_summary_general_item();
-    summary_item_set_u64(item, "Mint decimals", im_info->decimals);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_u64(item, SummaryTitleMintDecimals, im_info->decimals);
 
     if (im_info->freeze_authority != NULL) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Freeze authority", im_info->freeze_authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFreezeAuthority, im_info->freeze_authority);
     }
 
     if (print_config_show_authority(print_config, ca_info->from)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Funded by", ca_info->from);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFundedBy, ca_info->from);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_amount(item, "Funded with", ca_info->lamports);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleFundedWith, ca_info->lamports);
 
     return 0;
 }
@@ -472,22 +387,22 @@ static int print_spl_token_create_account(const PrintConfig* print_config,
     const SystemCreateAccountInfo* ca_info = &infos[0]->system.create_account;
     const SplTokenInitializeAccountInfo* ia_info = &infos[1]->spl_token.initialize_account;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create token acct", ia_info->token_account);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateTokenAcct, ia_info->token_account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From mint", ia_info->mint_account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFromMint, ia_info->mint_account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Owned by", ia_info->owner);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleOwnedBy, ia_info->owner);
 
     if (print_config_show_authority(print_config, ca_info->from)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Funded by", ca_info->from);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFundedBy, ca_info->from);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_amount(item, "Funded with", ca_info->lamports);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleFundedWith, ca_info->lamports);
 
     return 0;
 }
@@ -500,19 +415,19 @@ static int print_spl_token_create_multisig(const PrintConfig* print_config,
     const SystemCreateAccountInfo* ca_info = &infos[0]->system.create_account;
     const SplTokenInitializeMultisigInfo* im_info = &infos[1]->spl_token.initialize_multisig;
 
-    SummaryItem* item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Create multisig", im_info->multisig_account);
+    SummaryItem* item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleCreateMultisig, im_info->multisig_account);
 
-    item = transaction_summary_general_item();
+    item = summary_context_general_item(print_config->summary);
     summary_item_set_multisig_m_of_n(item, im_info->body.m, im_info->signers.count);
 
     if (print_config_show_authority(print_config, ca_info->from)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Funded by", ca_info->from);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleFundedBy, ca_info->from);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_amount(item, "Funded with", ca_info->lamports);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleFundedWith, ca_info->lamports);
 
     return 0;
 }
@@ -532,6 +447,84 @@ static int print_spl_associated_token_account_create_with_transfer(const PrintCo
     return 0;
 }
 
+static const TransactionPattern* find_transaction_pattern(uint32_t signature) {
+    size_t low = 0;
+    size_t high = ARRAY_LEN(transaction_patterns);
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const uint32_t mid_signature = transaction_patterns[mid].signature;
+        if (mid_signature == signature) {
+            return &transaction_patterns[mid];
+        }
+        if (mid_signature < signature) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+static int print_transaction_pattern(const PrintConfig* print_config,
+                                     InstructionInfo* const* infos,
+                                     size_t infos_length) {
+    const TransactionPattern* pattern =
+        find_transaction_pattern(instruction_infos_signature(infos, infos_length));
+    if (pattern == NULL) {
+        return 1;
+    }
+
+    switch (pattern->printer) {
+        case PrintCreateStakeAccount:
+            return print_create_stake_account(print_config, infos, infos_length);
+        case PrintCreateStakeAccountWithSeed:
+            return print_create_stake_account_with_seed(print_config, infos, infos_length);
+        case PrintCreateStakeAccountAndDelegate:
+            return print_create_stake_account_and_delegate(print_config, infos, infos_length);
+        case PrintCreateStakeAccountWithSeedAndDelegate:
+            return print_create_stake_account_with_seed_and_delegate(print_config,
+                                                                     infos,
+                                                                     infos_length);
+        case PrintStakeSplitV1_1:
+            // System allocate/assign have no interesting info, print
+            // stake split as if it were a single instruction
+            return print_stake_info(&infos[2]->stake, print_config);
+        case PrintStakeSplitWithSeedV1_1:
+            return print_stake_split_with_seed(print_config, infos, infos_length, true);
+        case PrintStakeSplitV1_2:
+            // System create account is issued with zero lamports in this
+            // case, so it has no interesting info to add. Print stake
+            // split as if it were a single instruction
+            return print_stake_info(&infos[1]->stake, print_config);
+        case PrintStakeSplitWithSeedV1_2:
+            return print_stake_split_with_seed(print_config, infos, infos_length, false);
+        case PrintStakeAuthorizeBoth:
+            return print_stake_authorize_both(print_config, infos, infos_length);
+        case PrintCreateNonceAccount:
+            return print_create_nonce_account(print_config, infos, infos_length);
+        case PrintCreateNonceAccountWithSeed:
+            return print_create_nonce_account_with_seed(print_config, infos, infos_length);
+        case PrintCreateVoteAccount:
+            return print_create_vote_account(print_config, infos, infos_length);
+        case PrintCreateVoteAccountWithSeed:
+            return print_create_vote_account_with_seed(print_config, infos, infos_length);
+        case PrintVoteAuthorizeBoth:
+            return print_vote_authorize_both(print_config, infos, infos_length);
+        case PrintSplTokenCreateMint:
+            return print_spl_token_create_mint(print_config, infos, infos_length);
+        case PrintSplTokenCreateAccount:
+            return print_spl_token_create_account(print_config, infos, infos_length);
+        case PrintSplTokenCreateMultisig:
+            return print_spl_token_create_multisig(print_config, infos, infos_length);
+        case PrintSplAssociatedTokenAccountCreateWithTransfer:
+            return print_spl_associated_token_account_create_with_transfer(print_config,
+                                                                           infos,
+                                                                           infos_length);
+    }
+
+    return 1;
+}
+
 static int print_transaction_nonce_processed(const PrintConfig* print_config,
                                              InstructionInfo* const* infos,
                                              size_t infos_length) {
@@ -557,66 +550,8 @@ static int print_transaction_nonce_processed(const PrintConfig* print_config,
             }
             break;
 
-        case 2:
-            if (is_create_stake_account(infos, infos_length) ||
-                is_create_stake_account_checked(infos, infos_length)) {
-                return print_create_stake_account(print_config, infos, infos_length);
-            } else if (is_create_stake_account_with_seed(infos, infos_length) ||
-                       is_create_stake_account_with_seed_checked(infos, infos_length)) {
-                return print_create_stake_account_with_seed(print_config, infos, infos_length);
-            } else if (is_create_nonce_account(infos, infos_length)) {
-                return print_create_nonce_account(print_config, infos, infos_length);
-            } else if (is_create_nonce_account_with_seed(infos, infos_length)) {
-                return print_create_nonce_account_with_seed(print_config, infos, infos_length);
-            } else if (is_create_vote_account(infos, infos_length)) {
-                return print_create_vote_account(print_config, infos, infos_length);
-            } else if (is_create_vote_account_with_seed(infos, infos_length)) {
-                return print_create_vote_account_with_seed(print_config, infos, infos_length);
-            } else if (is_stake_authorize_both(infos, infos_length) ||
-                       is_stake_authorize_checked_both(infos, infos_length)) {
-                return print_stake_authorize_both(print_config, infos, infos_length);
-            } else if (is_vote_authorize_both(infos, infos_length) ||
-                       is_vote_authorize_checked_both(infos, infos_length)) {
-                return print_vote_authorize_both(print_config, infos, infos_length);
-            } else if (is_stake_split_with_seed_v1_1(infos, infos_length)) {
-                return print_stake_split_with_seed(print_config, infos, infos_length, true);
-            } else if (is_stake_split_v1_2(infos, infos_length)) {
-                // System create account is issued with zero lamports in this
-                // case, so it has no interesting info to add. Print stake
-                // split as if it were a single instruction
-                return print_stake_info(&infos[1]->stake, print_config);
-            } else if (is_stake_split_with_seed_v1_2(infos, infos_length)) {
-                return print_stake_split_with_seed(print_config, infos, infos_length, false);
-            } else if (is_spl_token_create_mint(infos, infos_length)) {
-                return print_spl_token_create_mint(print_config, infos, infos_length);
-            } else if (is_spl_token_create_account(infos, infos_length) ||
-                       is_spl_token_create_account2(infos, infos_length)) {
-                return print_spl_token_create_account(print_config, infos, infos_length);
-            } else if (is_spl_token_create_multisig(infos, infos_length)) {
-                return print_spl_token_create_multisig(print_config, infos, infos_length);
-            } else if (is_spl_associated_token_account_create_with_transfer(infos, infos_length)) {
-                return print_spl_associated_token_account_create_with_transfer(print_config,
-                                                                               infos,
-                                                                               infos_length);
-            }
-            break;
-
-        case 3:
-            if (is_create_stake_account_and_delegate(infos, infos_length)) {
-                return print_create_stake_account_and_delegate(print_config, infos, infos_length);
-            } else if (is_create_stake_account_with_seed_and_delegate(infos, infos_length)) {
-                return print_create_stake_account_with_seed_and_delegate(print_config,
-                                                                         infos,
-                                                                         infos_length);
-            } else if (is_stake_split_v1_1(infos, infos_length)) {
-                // System allocate/assign have no interesting info, print
-                // stake split as if it were a single instruction
-                return print_stake_info(&infos[2]->stake, print_config);
-            }
-            break;
-
         default:
-            break;
+            return print_transaction_pattern(print_config, infos, infos_length);
     }
 
     return 1;
@@ -636,3 +571,15 @@ int print_transaction(const PrintConfig* print_config,
 
     return print_transaction_nonce_processed(print_config, infos, infos_length);
 }
+
+bool transaction_is_printable(const uint8_t* codes, size_t codes_length) {
+    // Same selection as print_transaction()
+    if ((codes_length > 1) && (codes[0] == SYSTEM_IX(SystemAdvanceNonceAccount))) {
+        codes++;
+        codes_length--;
+    }
+    if (codes_length == 1) {
+        return true;
+    }
+    return find_transaction_pattern(instruction_codes_signature(codes, codes_length)) != NULL;
+}
@@ -5,3 +5,8 @@
 int print_transaction(const PrintConfig* print_config,
                       InstructionInfo* const* infos,
                       size_t infos_length);
+
+// Whether print_transaction() has a summary for displayed instructions of
+// these codes, see instruction_info_code(). Printing may still fail on the
+// decoded instructions
+bool transaction_is_printable(const uint8_t* codes, size_t codes_length);
@@ -0,0 +1,60 @@
+#include "transaction_printers.c"
+#include <assert.h>
+#include <stdio.h>
+
+void test_transaction_patterns_sorted() {
+    for (size_t i = 1; i < ARRAY_LEN(transaction_patterns); i++) {
+        assert(transaction_patterns[i - 1].signature < transaction_patterns[i].signature);
+    }
+}
+
+void test_transaction_patterns_fit_displayed() {
+    // A nonce advance may come before any pattern
+    for (size_t i = 0; i < ARRAY_LEN(transaction_patterns); i++) {
+        assert(transaction_patterns[i].signature >> (8 * (MAX_DISPLAYED_INSTRUCTIONS - 1)) == 0);
+    }
+}
+
+void test_find_transaction_pattern() {
+    for (size_t i = 0; i < ARRAY_LEN(transaction_patterns); i++) {
+        assert(find_transaction_pattern(transaction_patterns[i].signature) ==
+               &transaction_patterns[i]);
+    }
+
+    assert(find_transaction_pattern(0) == NULL);
+    assert(find_transaction_pattern(UINT32_MAX) == NULL);
+    assert(find_transaction_pattern(
+               SIGNATURE2(SYSTEM_IX(SystemTransfer), SYSTEM_IX(SystemTransfer))) == NULL);
+}
+
+void test_transaction_is_printable() {
+    const uint8_t create_stake_account[] = {
+        SYSTEM_IX(SystemCreateAccount),
+        STAKE_IX(StakeInitialize),
+    };
+    const uint8_t nonced_create_stake_account[] = {
+        SYSTEM_IX(SystemAdvanceNonceAccount),
+        SYSTEM_IX(SystemCreateAccount),
+        STAKE_IX(StakeInitialize),
+    };
+    const uint8_t two_transfers[] = {
+        SYSTEM_IX(SystemTransfer),
+        SYSTEM_IX(SystemTransfer),
+    };
+
+    assert(transaction_is_printable(two_transfers, 1));
+    assert(transaction_is_printable(create_stake_account, ARRAY_LEN(create_stake_account)));
+    assert(transaction_is_printable(nonced_create_stake_account,
+                                    ARRAY_LEN(nonced_create_stake_account)));
+    assert(!transaction_is_printable(two_transfers, ARRAY_LEN(two_transfers)));
+}
+
+int main() {
+    test_transaction_patterns_sorted();
+    test_transaction_patterns_fit_displayed();
+    test_find_transaction_pattern();
+    test_transaction_is_printable();
+
+    printf("passed\n");
+    return 0;
+}
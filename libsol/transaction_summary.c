@@ -1,101 +1,133 @@
 #include "sol/parser.h"
 #include "sol/printer.h"
 #include "sol/transaction_summary.h"
+#include "token_info.h"
 #include "util.h"
+#include <stddef.h>
 #include <string.h>
 
-struct SummaryItem {
-    const char* title;
-    enum SummaryItemKind kind;
-    union {
-        uint64_t u64;
-        int64_t i64;
-        const Pubkey* pubkey;
-        const Hash* hash;
-        const char* string;
-        SizedString sized_string;
-        TokenAmount token_amount;
-    };
+// All the titles back to back, in the order of enum SummaryTitle. Each one
+// is a member so that its offset is known at compile time
+typedef struct SummaryTitleStrings {
+    char none[1];
+#define SUMMARY_TITLE_MEMBER(name, string) char name[sizeof(string)];
+    SUMMARY_TITLES(SUMMARY_TITLE_MEMBER)
+#undef SUMMARY_TITLE_MEMBER
+} SummaryTitleStrings;
+
+static const SummaryTitleStrings summary_titles = {
+    "",
+#define SUMMARY_TITLE_STRING(name, string) string,
+    SUMMARY_TITLES(SUMMARY_TITLE_STRING)
+#undef SUMMARY_TITLE_STRING
 };
 
-void summary_item_set_amount(SummaryItem* item, const char* title, uint64_t value) {
-    item->kind = SummaryItemAmount;
+static const uint16_t summary_title_offsets[] = {
+    offsetof(SummaryTitleStrings, none),
+#define SUMMARY_TITLE_OFFSET(name, string) offsetof(SummaryTitleStrings, name),
+    SUMMARY_TITLES(SUMMARY_TITLE_OFFSET)
+#undef SUMMARY_TITLE_OFFSET
+};
+
+_Static_assert(ARRAY_LEN(summary_title_offsets) <= UINT8_MAX + 1,
+               "Summary titles do not fit an item");
+_Static_assert(sizeof(SummaryTitleStrings) <= UINT16_MAX, "Summary titles do not fit an offset");
+
+const char* summary_title_string(enum SummaryTitle title) {
+    if ((size_t) title >= ARRAY_LEN(summary_title_offsets)) {
+        return "";
+    }
+    return (const char*) &summary_titles + summary_title_offsets[title];
+}
+
+static void summary_item_set(SummaryItem* item,
+                             enum SummaryItemKind kind,
+                             enum SummaryTitle title) {
+    explicit_bzero(item, sizeof(SummaryItem));
+    item->kind = kind;
     item->title = title;
-    item->u64 = value;
+}
+
+static void summary_item_set_value(SummaryItem* item,
+                                   enum SummaryItemKind kind,
+                                   enum SummaryTitle title,
+                                   uint64_t value) {
+    summary_item_set(item, kind, title);
+    memcpy(item->value, &value, sizeof(value));
+}
+
+static void summary_item_set_ref(SummaryItem* item,
+                                 enum SummaryItemKind kind,
+                                 enum SummaryTitle title,
+                                 const void* ref) {
+    summary_item_set(item, kind, title);
+    item->ref = ref;
+}
+
+static uint64_t summary_item_u64(const SummaryItem* item) {
+    uint64_t value;
+    memcpy(&value, item->value, sizeof(value));
+    return value;
+}
+
+static int64_t summary_item_i64(const SummaryItem* item) {
+    return (int64_t) summary_item_u64(item);
+}
+
+void summary_item_set_amount(SummaryItem* item, enum SummaryTitle title, uint64_t value) {
+    summary_item_set_value(item, SummaryItemAmount, title, value);
 }
 
 void summary_item_set_token_amount(SummaryItem* item,
-                                   const char* title,
+                                   enum SummaryTitle title,
                                    uint64_t value,
-                                   const char* symbol,
+                                   const Pubkey* mint,
                                    uint8_t decimals) {
-    item->kind = SummaryItemTokenAmount;
-    item->title = title;
-    item->token_amount.value = value;
-    item->token_amount.symbol = symbol;
-    item->token_amount.decimals = decimals;
+    summary_item_set_value(item, SummaryItemTokenAmount, title, value);
+    item->decimals = decimals;
+    item->token = get_token_index(mint);
 }
 
-void summary_item_set_i64(SummaryItem* item, const char* title, int64_t value) {
-    item->kind = SummaryItemI64;
-    item->title = title;
-    item->i64 = value;
+void summary_item_set_i64(SummaryItem* item, enum SummaryTitle title, int64_t value) {
+    summary_item_set_value(item, SummaryItemI64, title, (uint64_t) value);
 }
 
-void summary_item_set_u64(SummaryItem* item, const char* title, uint64_t value) {
-    item->kind = SummaryItemU64;
-    item->title = title;
-    item->u64 = value;
+void summary_item_set_u64(SummaryItem* item, enum SummaryTitle title, uint64_t value) {
+    summary_item_set_value(item, SummaryItemU64, title, value);
 }
 
-void summary_item_set_pubkey(SummaryItem* item, const char* title, const Pubkey* value) {
-    item->kind = SummaryItemPubkey;
-    item->title = title;
-    item->pubkey = value;
+void summary_item_set_pubkey(SummaryItem* item, enum SummaryTitle title, const Pubkey* value) {
+    summary_item_set_ref(item, SummaryItemPubkey, title, value);
 }
 
-void summary_item_set_hash(SummaryItem* item, const char* title, const Hash* value) {
-    item->kind = SummaryItemHash;
-    item->title = title;
-    item->hash = value;
+void summary_item_set_hash(SummaryItem* item, enum SummaryTitle title, const Hash* value) {
+    summary_item_set_ref(item, SummaryItemHash, title, value);
 }
 
-void summary_item_set_sized_string(SummaryItem* item, const char* title, const SizedString* value) {
-    item->kind = SummaryItemSizedString;
-    item->title = title;
-    item->sized_string.length = value->length;
-    item->sized_string.string = value->string;
+void summary_item_set_sized_string(SummaryItem* item,
+                                   enum SummaryTitle title,
+                                   const SizedString* value) {
+    summary_item_set_ref(item, SummaryItemSizedString, title, value->string);
+    // Anything past TEXT_BUFFER_LENGTH is truncated on display anyway
+    item->length = (value->length > UINT16_MAX) ? UINT16_MAX : value->length;
 }
 
-void summary_item_set_string(SummaryItem* item, const char* title, const char* value) {
-    item->kind = SummaryItemString;
-    item->title = title;
-    item->string = value;
+void summary_item_set_string(SummaryItem* item, enum SummaryTitle title, const char* value) {
+    summary_item_set_ref(item, SummaryItemString, title, value);
 }
 
-void summary_item_set_timestamp(SummaryItem* item, const char* title, int64_t value) {
-    item->kind = SummaryItemTimestamp;
-    item->title = title;
-    item->i64 = value;
+void summary_item_set_timestamp(SummaryItem* item, enum SummaryTitle title, int64_t value) {
+    summary_item_set_value(item, SummaryItemTimestamp, title, (uint64_t) value);
 }
 
-typedef struct TransactionSummary {
-    SummaryItem primary;
-    SummaryItem fee_payer;
-    SummaryItem nonce_account;
-    SummaryItem nonce_authority;
-    SummaryItem general[NUM_GENERAL_ITEMS];
-} TransactionSummary;
+TransactionSummaryContext G_transaction_summary_context;
 
-static TransactionSummary G_transaction_summary;
-
-char G_transaction_summary_title[TITLE_SIZE];
-char G_transaction_summary_text[TEXT_BUFFER_LENGTH];
+static TransactionSummaryContext* summary_context(TransactionSummaryContext* ctx) {
+    return (ctx != NULL) ? ctx : &G_transaction_summary_context;
+}
 
-void transaction_summary_reset() {
-    explicit_bzero(&G_transaction_summary, sizeof(TransactionSummary));
-    explicit_bzero(&G_transaction_summary_title, TITLE_SIZE);
-    explicit_bzero(&G_transaction_summary_text, TEXT_BUFFER_LENGTH);
+void summary_context_reset(TransactionSummaryContext* ctx) {
+    explicit_bzero(summary_context(ctx), sizeof(TransactionSummaryContext));
 }
 
 static bool is_summary_item_used(const SummaryItem* item) {
@@ -109,73 +141,84 @@ static SummaryItem* summary_item_as_unused(SummaryItem* item) {
     return NULL;
 }
 
-SummaryItem* transaction_summary_primary_item() {
-    SummaryItem* item = &G_transaction_summary.primary;
-    return summary_item_as_unused(item);
+// Setting an item may shift the display steps, so drop what was rendered
+static SummaryItem* summary_context_unused_item(TransactionSummaryContext* ctx,
+                                                SummaryItem* item) {
+    item = summary_item_as_unused(item);
+    if (item != NULL) {
+        ctx->step_count = 0;
+    }
+    return item;
 }
 
-SummaryItem* transaction_summary_fee_payer_item() {
-    SummaryItem* item = &G_transaction_summary.fee_payer;
-    return summary_item_as_unused(item);
+SummaryItem* summary_context_primary_item(TransactionSummaryContext* ctx) {
+    ctx = summary_context(ctx);
+    return summary_context_unused_item(ctx, &ctx->summary.primary);
 }
 
-SummaryItem* transaction_summary_nonce_account_item() {
-    SummaryItem* item = &G_transaction_summary.nonce_account;
-    return summary_item_as_unused(item);
+SummaryItem* summary_context_fee_payer_item(TransactionSummaryContext* ctx) {
+    ctx = summary_context(ctx);
+    return summary_context_unused_item(ctx, &ctx->summary.fee_payer);
 }
 
-SummaryItem* transaction_summary_nonce_authority_item() {
-    SummaryItem* item = &G_transaction_summary.nonce_authority;
-    return summary_item_as_unused(item);
+SummaryItem* summary_context_nonce_account_item(TransactionSummaryContext* ctx) {
+    ctx = summary_context(ctx);
+    return summary_context_unused_item(ctx, &ctx->summary.nonce_account);
 }
 
-SummaryItem* transaction_summary_general_item() {
+SummaryItem* summary_context_nonce_authority_item(TransactionSummaryContext* ctx) {
+    ctx = summary_context(ctx);
+    return summary_context_unused_item(ctx, &ctx->summary.nonce_authority);
+}
+
+SummaryItem* summary_context_general_item(TransactionSummaryContext* ctx) {
+    ctx = summary_context(ctx);
     for (size_t i = 0; i < NUM_GENERAL_ITEMS; i++) {
-        SummaryItem* item = &G_transaction_summary.general[i];
-        if (!is_summary_item_used(item)) {
+        SummaryItem* item = summary_context_unused_item(ctx, &ctx->summary.general[i]);
+        if (item != NULL) {
             return item;
         }
     }
     return NULL;
 }
 
-#define FEE_PAYER_TITLE "Fee payer"
-int transaction_summary_set_fee_payer_pubkey(const Pubkey* pubkey) {
-    SummaryItem* item = transaction_summary_fee_payer_item();
+#define FEE_PAYER_TITLE SummaryTitleFeePayer
+int summary_context_set_fee_payer_pubkey(TransactionSummaryContext* ctx, const Pubkey* pubkey) {
+    SummaryItem* item = summary_context_fee_payer_item(ctx);
     BAIL_IF(item == NULL);
     summary_item_set_pubkey(item, FEE_PAYER_TITLE, pubkey);
     return 0;
 }
 
-static int transaction_summary_update_display_for_item(const SummaryItem* item,
-                                                       enum DisplayFlags flags) {
+// Render the text of `item` into `text`, TEXT_BUFFER_LENGTH long
+static int summary_item_render(const SummaryItem* item, enum DisplayFlags flags, char* text) {
     switch (item->kind) {
         case SummaryItemNone:
             return 1;
         case SummaryItemAmount:
-            BAIL_IF(print_amount(item->u64, G_transaction_summary_text, BASE58_PUBKEY_LENGTH));
+            BAIL_IF(print_amount(summary_item_u64(item), text, BASE58_PUBKEY_LENGTH));
             break;
         case SummaryItemTokenAmount:
-            BAIL_IF(print_token_amount(item->token_amount.value,
-                                       item->token_amount.symbol,
-                                       item->token_amount.decimals,
-                                       G_transaction_summary_text,
+            BAIL_IF(print_token_amount(summary_item_u64(item),
+                                       get_token_symbol(item->token),
+                                       item->decimals,
+                                       text,
                                        TEXT_BUFFER_LENGTH));
             break;
         case SummaryItemI64:
-            BAIL_IF(print_i64(item->i64, G_transaction_summary_text, TEXT_BUFFER_LENGTH));
+            BAIL_IF(print_i64(summary_item_i64(item), text, TEXT_BUFFER_LENGTH));
             break;
         case SummaryItemU64:
-            BAIL_IF(print_u64(item->u64, G_transaction_summary_text, TEXT_BUFFER_LENGTH));
+            BAIL_IF(print_u64(summary_item_u64(item), text, TEXT_BUFFER_LENGTH));
             break;
         case SummaryItemPubkey: {
             char tmp_buf[BASE58_PUBKEY_LENGTH];
-            BAIL_IF(encode_base58(item->pubkey, PUBKEY_SIZE, tmp_buf, sizeof(tmp_buf)));
+            BAIL_IF(encode_base58(item->ref, PUBKEY_SIZE, tmp_buf, sizeof(tmp_buf)));
             if (flags & DisplayFlagLongPubkeys) {
-                BAIL_IF(print_string(tmp_buf, G_transaction_summary_text, TEXT_BUFFER_LENGTH));
+                BAIL_IF(print_string(tmp_buf, text, TEXT_BUFFER_LENGTH));
             } else {
                 BAIL_IF(print_summary(tmp_buf,
-                                      G_transaction_summary_text,
+                                      text,
                                       BASE58_PUBKEY_SHORT,
                                       SUMMARY_LENGTH,
                                       SUMMARY_LENGTH));
@@ -183,34 +226,42 @@ static int transaction_summary_update_display_for_item(const SummaryItem* item,
             break;
         }
         case SummaryItemHash:
-            BAIL_IF(encode_base58(item->hash,
+            BAIL_IF(encode_base58(item->ref,
                                   BLOCKHASH_SIZE,
-                                  G_transaction_summary_text,
+                                  text,
                                   TEXT_BUFFER_LENGTH));
             break;
         case SummaryItemString:
-            print_string(item->string, G_transaction_summary_text, TEXT_BUFFER_LENGTH);
+            print_string(item->ref, text, TEXT_BUFFER_LENGTH);
             break;
-        case SummaryItemSizedString:
-            print_sized_string(&item->sized_string, G_transaction_summary_text, TEXT_BUFFER_LENGTH);
+        case SummaryItemSizedString: {
+            const SizedString sized_string = {item->length, item->ref};
+            print_sized_string(&sized_string, text, TEXT_BUFFER_LENGTH);
             break;
+        }
         case SummaryItemTimestamp:
-            BAIL_IF(print_timestamp(item->i64, G_transaction_summary_text, TEXT_BUFFER_LENGTH));
+            BAIL_IF(print_timestamp(summary_item_i64(item), text, TEXT_BUFFER_LENGTH));
             break;
     }
-    print_string(item->title, G_transaction_summary_title, TITLE_SIZE);
     return 0;
 }
 
-// find item_index in G_transaction_summary in the following order:
+static int transaction_summary_update_display_for_item(TransactionSummaryContext* ctx,
+                                                       const SummaryItem* item,
+                                                       enum DisplayFlags flags) {
+    BAIL_IF(summary_item_render(item, flags, ctx->text));
+    print_string(summary_title_string(item->title), ctx->title, TITLE_SIZE);
+    return 0;
+}
+
+// find item_index in the summary in the following order:
 //     summary->primary
 //     used items of summary->general[]
 //     used summary->nonce_account
 //     used summary->nonce_authority
 //     summary->fee_payer
 
-static SummaryItem* transaction_summary_find_item(size_t item_index) {
-    struct TransactionSummary* summary = &G_transaction_summary;
+static SummaryItem* transaction_summary_find_item(TransactionSummary* summary, size_t item_index) {
     size_t current_index = 0;
 
     if (current_index == item_index) {
@@ -248,42 +299,122 @@ static SummaryItem* transaction_summary_find_item(size_t item_index) {
     return NULL;
 }
 
-int transaction_summary_display_item(size_t item_index, enum DisplayFlags flags) {
+// Position of each item in the display order of a full summary, which is
+// how display steps refer to them
+enum SummaryItemPosition {
+    SummaryItemPositionPrimary = 0,
+    SummaryItemPositionGeneral,
+    SummaryItemPositionNonceAccount = SummaryItemPositionGeneral + NUM_GENERAL_ITEMS,
+    SummaryItemPositionNonceAuthority,
+    SummaryItemPositionFeePayer,
+};
+
+_Static_assert(SummaryItemPositionFeePayer <= UINT8_MAX, "Summary item positions do not fit a step");
+
+static const SummaryItem* summary_item_at(const TransactionSummary* summary, uint8_t position) {
+    switch (position) {
+        case SummaryItemPositionPrimary:
+            return &summary->primary;
+        case SummaryItemPositionNonceAccount:
+            return &summary->nonce_account;
+        case SummaryItemPositionNonceAuthority:
+            return &summary->nonce_authority;
+        case SummaryItemPositionFeePayer:
+            return &summary->fee_payer;
+        default:
+            return &summary->general[position - SummaryItemPositionGeneral];
+    }
+}
+
+int summary_context_display_item(TransactionSummaryContext* ctx,
+                                 size_t item_index,
+                                 enum DisplayFlags flags) {
     const SummaryItem* item;
 
-    item = transaction_summary_find_item(item_index);
+    ctx = summary_context(ctx);
+    if (item_index < ctx->step_count) {
+        item = summary_item_at(&ctx->summary, ctx->steps[item_index]);
+    } else {
+        // Not finalized yet
+        item = transaction_summary_find_item(&ctx->summary, item_index);
+    }
     if (item == NULL) {
         return 1;
     }
 
-    return transaction_summary_update_display_for_item(item, flags);
+    return transaction_summary_update_display_for_item(ctx, item, flags);
 }
 
-#define SET_IF_USED(item, item_kinds, index) \
-    do {                                     \
-        if (item.kind != SummaryItemNone) {  \
-            item_kinds[index++] = item.kind; \
-        }                                    \
-    } while (0)
+static void summary_context_add_step(TransactionSummaryContext* ctx,
+                                     uint8_t position,
+                                     enum SummaryItemKind* item_kinds,
+                                     size_t* index) {
+    const SummaryItem* item = summary_item_at(&ctx->summary, position);
+    if (is_summary_item_used(item)) {
+        ctx->steps[*index] = position;
+        item_kinds[(*index)++] = item->kind;
+    }
+}
 
-int transaction_summary_finalize(enum SummaryItemKind* item_kinds, size_t* item_kinds_len) {
-    const TransactionSummary* summary = &G_transaction_summary;
+int summary_context_finalize(TransactionSummaryContext* ctx,
+                             enum SummaryItemKind* item_kinds,
+                             size_t* item_kinds_len) {
+    ctx = summary_context(ctx);
     size_t index = 0;
 
-    if (summary->primary.kind == SummaryItemNone) {
+    if (ctx->summary.primary.kind == SummaryItemNone) {
         return 1;
     }
 
-    SET_IF_USED(summary->primary, item_kinds, index);
+    ctx->step_count = 0;
+
+    summary_context_add_step(ctx, SummaryItemPositionPrimary, item_kinds, &index);
 
     for (size_t i = 0; i < NUM_GENERAL_ITEMS; i++) {
-        SET_IF_USED(summary->general[i], item_kinds, index);
+        summary_context_add_step(ctx, SummaryItemPositionGeneral + i, item_kinds, &index);
     }
 
-    SET_IF_USED(summary->nonce_account, item_kinds, index);
-    SET_IF_USED(summary->nonce_authority, item_kinds, index);
-    SET_IF_USED(summary->fee_payer, item_kinds, index);
+    summary_context_add_step(ctx, SummaryItemPositionNonceAccount, item_kinds, &index);
+    summary_context_add_step(ctx, SummaryItemPositionNonceAuthority, item_kinds, &index);
+    summary_context_add_step(ctx, SummaryItemPositionFeePayer, item_kinds, &index);
 
+    ctx->step_count = index;
     *item_kinds_len = index;
     return 0;
 }
+
+void transaction_summary_reset() {
+    summary_context_reset(NULL);
+}
+
+int transaction_summary_display_item(size_t item_index, enum DisplayFlags flags) {
+    return summary_context_display_item(NULL, item_index, flags);
+}
+
+int transaction_summary_finalize(enum SummaryItemKind* item_kinds, size_t* item_kinds_len) {
+    return summary_context_finalize(NULL, item_kinds, item_kinds_len);
+}
+
+SummaryItem* transaction_summary_primary_item() {
+    return summary_context_primary_item(NULL);
+}
+
+SummaryItem* transaction_summary_fee_payer_item() {
+    return summary_context_fee_payer_item(NULL);
+}
+
+SummaryItem* transaction_summary_nonce_account_item() {
+    return summary_context_nonce_account_item(NULL);
+}
+
+SummaryItem* transaction_summary_nonce_authority_item() {
+    return summary_context_nonce_authority_item(NULL);
+}
+
+SummaryItem* transaction_summary_general_item() {
+    return summary_context_general_item(NULL);
+}
+
+int transaction_summary_set_fee_payer_pubkey(const Pubkey* pubkey) {
+    return summary_context_set_fee_payer_pubkey(NULL, pubkey);
+}
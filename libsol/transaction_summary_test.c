@@ -3,64 +3,94 @@
 #include <assert.h>
 #include <stdio.h>
 
+void test_summary_title_string() {
+    assert_string_equal(summary_title_string(SummaryTitleNone), "");
+    assert_string_equal(summary_title_string(SummaryTitleAdvanceNonce), "Advance nonce");
+    assert_string_equal(summary_title_string(SummaryTitleFeePayer), "Fee payer");
+    assert_string_equal(summary_title_string(SummaryTitleWithdrawTo), "Withdraw to");
+    assert_string_equal(summary_title_string((enum SummaryTitle) UINT8_MAX), "");
+
+    // Every title follows the previous one in the table
+    for (size_t title = SummaryTitleAdvanceNonce; title <= SummaryTitleWithdrawTo; title++) {
+        const char* previous = summary_title_string(title - 1);
+        assert(summary_title_string(title) == previous + strlen(previous) + 1);
+    }
+}
+
 void test_summary_item_setters() {
     SummaryItem item;
+    const Pubkey mint = {{PROGRAM_ID_SPL_TOKEN}};
 
-    summary_item_set_amount(&item, "amount", 42);
+    summary_item_set_amount(&item, SummaryTitleTransfer, 42);
     assert(item.kind == SummaryItemAmount);
-    assert_string_equal(item.title, "amount");
-    assert(item.u64 == 42);
+    assert(item.title == SummaryTitleTransfer);
+    assert(summary_item_u64(&item) == 42);
 
-    summary_item_set_token_amount(&item, "token", 42, "TST", 2);
+    summary_item_set_token_amount(&item, SummaryTitleTransferTokens, 42, &mint, 2);
     assert(item.kind == SummaryItemTokenAmount);
-    assert_string_equal(item.title, "token");
-    assert(item.token_amount.value == 42);
-    assert_string_equal(item.token_amount.symbol, "TST");
-    assert(item.token_amount.decimals == 2);
+    assert(item.title == SummaryTitleTransferTokens);
+    assert(summary_item_u64(&item) == 42);
+    assert(item.token == 0);
+    assert(item.decimals == 2);
 
-    summary_item_set_i64(&item, "i64", -42);
+    const Pubkey unknown_mint = {{BYTES32_BS58_4}};
+    summary_item_set_token_amount(&item, SummaryTitleTransferTokens, 42, &unknown_mint, 2);
+    assert(item.token == TOKEN_INDEX_UNKNOWN);
+    assert_string_equal(get_token_symbol(item.token), "???");
+
+    summary_item_set_i64(&item, SummaryTitleEpoch, -42);
     assert(item.kind == SummaryItemI64);
-    assert_string_equal(item.title, "i64");
-    assert(item.i64 == -42);
+    assert(item.title == SummaryTitleEpoch);
+    assert(summary_item_i64(&item) == -42);
 
-    summary_item_set_u64(&item, "u64", 4242);
+    summary_item_set_u64(&item, SummaryTitleCommission, 4242);
     assert(item.kind == SummaryItemU64);
-    assert_string_equal(item.title, "u64");
-    assert(item.u64 == 4242);
+    assert(item.title == SummaryTitleCommission);
+    assert(summary_item_u64(&item) == 4242);
 
     Pubkey pubkey = {{BYTES32_BS58_2}};
-    summary_item_set_pubkey(&item, "pubkey", &pubkey);
+    summary_item_set_pubkey(&item, SummaryTitleSender, &pubkey);
     assert(item.kind == SummaryItemPubkey);
-    assert_string_equal(item.title, "pubkey");
-    assert(item.pubkey == &pubkey);
+    assert(item.title == SummaryTitleSender);
+    assert(item.ref == &pubkey);
 
     Hash hash = {{BYTES32_BS58_3}};
-    summary_item_set_hash(&item, "hash", &hash);
+    summary_item_set_hash(&item, SummaryTitleHash, &hash);
     assert(item.kind == SummaryItemHash);
-    assert_string_equal(item.title, "hash");
-    assert(item.hash == &hash);
+    assert(item.title == SummaryTitleHash);
+    assert(item.ref == &hash);
 
     const char* string = "value";
-    summary_item_set_string(&item, "string", string);
+    summary_item_set_string(&item, SummaryTitleSign, string);
     assert(item.kind == SummaryItemString);
-    assert_string_equal(item.title, "string");
-    assert(item.string == string);
+    assert(item.title == SummaryTitleSign);
+    assert(item.ref == string);
 
     uint8_t string_data[4] = {0x74, 0x65, 0x73, 0x74};
     SizedString sized_string = {
         sizeof(string_data),
         (char*) string_data,
     };
-    summary_item_set_sized_string(&item, "sizedString", &sized_string);
+    summary_item_set_sized_string(&item, SummaryTitleSeed, &sized_string);
     assert(item.kind == SummaryItemSizedString);
-    assert_string_equal(item.title, "sizedString");
-    assert(item.sized_string.length == sizeof(string_data));
-    assert(strncmp("test", item.sized_string.string, item.sized_string.length) == 0);
+    assert(item.title == SummaryTitleSeed);
+    assert(item.length == sizeof(string_data));
+    assert(strncmp("test", item.ref, item.length) == 0);
+
+    // Lengths saturate, the display truncates well before
+    sized_string.length = (uint64_t) UINT16_MAX + 1;
+    summary_item_set_sized_string(&item, SummaryTitleSeed, &sized_string);
+    assert(item.length == UINT16_MAX);
 
-    summary_item_set_timestamp(&item, "timestamp", 42);
+    summary_item_set_i64(&item, SummaryTitleEpoch, INT64_MIN);
+    assert(summary_item_i64(&item) == INT64_MIN);
+    summary_item_set_u64(&item, SummaryTitleCommission, UINT64_MAX);
+    assert(summary_item_u64(&item) == UINT64_MAX);
+
+    summary_item_set_timestamp(&item, SummaryTitleLockupTime, 42);
     assert(item.kind == SummaryItemTimestamp);
-    assert_string_equal(item.title, "timestamp");
-    assert(item.i64 == 42);
+    assert(item.title == SummaryTitleLockupTime);
+    assert(summary_item_i64(&item) == 42);
 }
 
 void test_summary_item_as_unused() {
@@ -98,7 +128,7 @@ void test_summary_item_as_unused() {
 }
 
 void test_transaction_summary_reset() {
-    memset(&G_transaction_summary, 1, sizeof(TransactionSummary));
+    memset(&G_transaction_summary_context.summary, 1, sizeof(TransactionSummary));
     memset(G_transaction_summary_title, 1, TITLE_SIZE);
     memset(G_transaction_summary_text, 1, TEXT_BUFFER_LENGTH);
 
@@ -131,24 +161,24 @@ void test_transaction_summary_item_getters() {
     SummaryItem* item;
 
     assert((item = transaction_summary_primary_item()) != NULL);
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     assert(transaction_summary_primary_item() == NULL);
 
     assert((item = transaction_summary_fee_payer_item()) != NULL);
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     assert(transaction_summary_fee_payer_item() == NULL);
 
     assert((item = transaction_summary_nonce_account_item()) != NULL);
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     assert(transaction_summary_nonce_account_item() == NULL);
 
     assert((item = transaction_summary_nonce_authority_item()) != NULL);
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     assert(transaction_summary_nonce_authority_item() == NULL);
 
     for (size_t i = 0; i < NUM_GENERAL_ITEMS; i++) {
         assert((item = transaction_summary_general_item()) != NULL);
-        summary_item_set_u64(item, "item", 42);
+        summary_item_set_u64(item, SummaryTitleType, 42);
     }
     assert(transaction_summary_general_item() == NULL);
 }
@@ -160,88 +190,92 @@ void test_transaction_summary_item_getters() {
     } while (0)
 
 void test_transaction_summary_update_display_for_item() {
+    TransactionSummaryContext* ctx = &G_transaction_summary_context;
     SummaryItem item;
+    const Pubkey mint = {{PROGRAM_ID_SPL_TOKEN}};
 
     item.kind = SummaryItemNone;
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 1);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 1);
 
-    summary_item_set_amount(&item, "amount", 42);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("amount", "0.000000042 SOL");
+    summary_item_set_amount(&item, SummaryTitleTransfer, 42);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Transfer", "0.000000042 SOL");
 
-    summary_item_set_token_amount(&item, "token", 42, "TST", 2);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("token", "0.42 TST");
+    summary_item_set_token_amount(&item, SummaryTitleTransferTokens, 42, &mint, 2);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Transfer tokens", "0.42 WSOL");
 
-    summary_item_set_i64(&item, "i64", -42);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("i64", "-42");
+    summary_item_set_i64(&item, SummaryTitleEpoch, -42);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Epoch", "-42");
 
-    summary_item_set_u64(&item, "u64", 4242);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("u64", "4242");
+    summary_item_set_u64(&item, SummaryTitleCommission, 4242);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Commission", "4242");
 
     Pubkey pubkey;
     explicit_bzero(&pubkey, sizeof(Pubkey));
-    summary_item_set_pubkey(&item, "pubkey", &pubkey);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("pubkey", "1111111..1111111");
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagLongPubkeys) == 0);
-    assert_transaction_summary_display("pubkey", "11111111111111111111111111111111");
+    summary_item_set_pubkey(&item, SummaryTitleSender, &pubkey);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Sender", "1111111..1111111");
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagLongPubkeys) == 0);
+    assert_transaction_summary_display("Sender", "11111111111111111111111111111111");
 
     Hash hash;
     explicit_bzero(&hash, sizeof(Hash));
-    summary_item_set_hash(&item, "hash", &hash);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("hash", "11111111111111111111111111111111");
+    summary_item_set_hash(&item, SummaryTitleHash, &hash);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Hash", "11111111111111111111111111111111");
 
     uint8_t string_data[] = {0x74, 0x65, 0x73, 0x74};
     SizedString sized_string = {sizeof(string_data), (char*) string_data};
-    summary_item_set_sized_string(&item, "sizedString", &sized_string);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("sizedString", "test");
+    summary_item_set_sized_string(&item, SummaryTitleSeed, &sized_string);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Seed", "test");
 
     const char* string = "value";
-    summary_item_set_string(&item, "string", string);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("string", "value");
+    summary_item_set_string(&item, SummaryTitleSign, string);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Sign", "value");
 
-    summary_item_set_timestamp(&item, "timestamp", 42);
-    assert(transaction_summary_update_display_for_item(&item, DisplayFlagNone) == 0);
-    assert_transaction_summary_display("timestamp", "1970-01-01 00:00:42");
+    summary_item_set_timestamp(&item, SummaryTitleLockupTime, 42);
+    assert(transaction_summary_update_display_for_item(ctx, &item, DisplayFlagNone) == 0);
+    assert_transaction_summary_display("Lockup time", "1970-01-01 00:00:42");
 }
 
-#define display_item_test_helper(item, item_index)                                  \
+#define display_item_test_helper(item, title, item_index)                           \
     do {                                                                            \
         SummaryItem* si;                                                            \
         assert((si = transaction_summary_##item##_item()) != NULL);                 \
-        summary_item_set_u64(si, #item, 42);                                        \
+        summary_item_set_u64(si, title, 42);                                        \
         assert(transaction_summary_display_item(item_index, DisplayFlagNone) == 0); \
-        assert_transaction_summary_display(#item, "42");                            \
+        assert_transaction_summary_display(summary_title_string(title), "42");      \
     } while (0)
 
 #define display_item_test_helper_general_item(general_index)                               \
     do {                                                                                   \
         SummaryItem* si;                                                                   \
-        const char* title = "general_" #general_index;                                     \
+        const enum SummaryTitle title = SummaryTitleNone + 1 + general_index;              \
         assert((si = transaction_summary_general_item()) != NULL);                         \
         summary_item_set_u64(si, title, 42);                                               \
         assert(transaction_summary_display_item(general_index + 1, DisplayFlagNone) == 0); \
-        assert_transaction_summary_display(title, "42");                                   \
+        assert_transaction_summary_display(summary_title_string(title), "42");             \
     } while (0)
 
 void test_transaction_summary_display_item() {
     transaction_summary_reset();
 
-    display_item_test_helper(primary, 0);
+    display_item_test_helper(primary, SummaryTitleTransfer, 0);
 
     for (size_t i = 0; i < NUM_GENERAL_ITEMS; i++) {
         display_item_test_helper_general_item(i);
     }
 
-    display_item_test_helper(nonce_account, 1 + NUM_GENERAL_ITEMS);
-    display_item_test_helper(nonce_authority, 1 + NUM_GENERAL_ITEMS + 1);
-    display_item_test_helper(fee_payer, 1 + NUM_GENERAL_ITEMS + 2);
+    display_item_test_helper(nonce_account, SummaryTitleNonceAccount, 1 + NUM_GENERAL_ITEMS);
+    display_item_test_helper(nonce_authority,
+                             SummaryTitleNonceAuthority,
+                             1 + NUM_GENERAL_ITEMS + 1);
+    display_item_test_helper(fee_payer, SummaryTitleFeePayer, 1 + NUM_GENERAL_ITEMS + 2);
 }
 
 #define zero_kinds_array(kinds) \
@@ -272,23 +306,23 @@ void test_transaction_summary_finalize() {
     size_t i;
     for (i = 0; i < NUM_GENERAL_ITEMS; i++) {
         item = transaction_summary_general_item();
-        summary_item_set_u64(item, "item", 42);
+        summary_item_set_u64(item, SummaryTitleType, 42);
     }
     item = transaction_summary_nonce_account_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     item = transaction_summary_nonce_authority_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     assert(transaction_summary_finalize(kinds, &num_kinds) == 1);
 
     // No primary set fails
     item = transaction_summary_fee_payer_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     assert(transaction_summary_finalize(kinds, &num_kinds) == 1);
 
     // Minimum items set (primary) succeeds
     transaction_summary_reset();
     item = transaction_summary_primary_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     num_kinds = 0;
     zero_kinds_array(kinds);
     assert(transaction_summary_finalize(kinds, &num_kinds) == 0);
@@ -296,7 +330,7 @@ void test_transaction_summary_finalize() {
     assert_kinds_array(kinds, num_kinds);
 
     item = transaction_summary_fee_payer_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     num_kinds = 0;
     zero_kinds_array(kinds);
     assert(transaction_summary_finalize(kinds, &num_kinds) == 0);
@@ -306,7 +340,7 @@ void test_transaction_summary_finalize() {
     // Optionals still succeed and count
     for (i = 0; i < NUM_GENERAL_ITEMS; i++) {
         item = transaction_summary_general_item();
-        summary_item_set_u64(item, "item", 42);
+        summary_item_set_u64(item, SummaryTitleType, 42);
         num_kinds = 0;
         zero_kinds_array(kinds);
         assert(transaction_summary_finalize(kinds, &num_kinds) == 0);
@@ -315,7 +349,7 @@ void test_transaction_summary_finalize() {
     }
 
     item = transaction_summary_nonce_account_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     num_kinds = 0;
     zero_kinds_array(kinds);
     assert(transaction_summary_finalize(kinds, &num_kinds) == 0);
@@ -323,7 +357,7 @@ void test_transaction_summary_finalize() {
     assert_kinds_array(kinds, num_kinds);
 
     item = transaction_summary_nonce_authority_item();
-    summary_item_set_u64(item, "item", 42);
+    summary_item_set_u64(item, SummaryTitleType, 42);
     num_kinds = 0;
     zero_kinds_array(kinds);
     assert(transaction_summary_finalize(kinds, &num_kinds) == 0);
@@ -333,14 +367,14 @@ void test_transaction_summary_finalize() {
 
 void test_repro_unrecognized_format_reverse_nav_hash_corruption_bug() {
     SummaryItem* item;
-    const char* primary_title = "Unrecognized";
+    const enum SummaryTitle primary_title = SummaryTitleUnrecognized;
     const char* primary_text = "format";
-    const char* fee_payer_title = FEE_PAYER_TITLE;
+    const enum SummaryTitle fee_payer_title = FEE_PAYER_TITLE;
     const char* fee_payer_text = "1111111..1111111";
     Pubkey fee_payer = {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}};
-    const char* message_hash_title = "Message hash";
+    const enum SummaryTitle message_hash_title = SummaryTitleMessageHash;
     const char* message_hash_text = "22222222222222222222222222222222222222222222";
     Hash message_hash = {{0x0f, 0x1e, 0x6b, 0x14, 0x21, 0xc0, 0x4a, 0x07, 0x04, 0x31, 0x26,
                           0x5c, 0x19, 0xc5, 0xbb, 0xee, 0x19, 0x92, 0xba, 0xe8, 0xaf, 0xd1,
@@ -362,18 +396,141 @@ void test_repro_unrecognized_format_reverse_nav_hash_corruption_bug() {
     assert(num_kinds == 3);
 
     assert(transaction_summary_display_item(0, DisplayFlagNone) == 0);
-    assert_transaction_summary_display(primary_title, primary_text);
+    assert_transaction_summary_display(summary_title_string(primary_title), primary_text);
     assert(transaction_summary_display_item(1, DisplayFlagNone) == 0);
-    assert_transaction_summary_display(message_hash_title, message_hash_text);
+    assert_transaction_summary_display(summary_title_string(message_hash_title), message_hash_text);
     assert(transaction_summary_display_item(2, DisplayFlagNone) == 0);
-    assert_transaction_summary_display(fee_payer_title, fee_payer_text);
+    assert_transaction_summary_display(summary_title_string(fee_payer_title), fee_payer_text);
     assert(transaction_summary_display_item(1, DisplayFlagNone) == 0);
-    assert_transaction_summary_display(message_hash_title, message_hash_text);
+    assert_transaction_summary_display(summary_title_string(message_hash_title), message_hash_text);
     assert(transaction_summary_display_item(0, DisplayFlagNone) == 0);
-    assert_transaction_summary_display(primary_title, primary_text);
+    assert_transaction_summary_display(summary_title_string(primary_title), primary_text);
+}
+
+// Displays every step through the finalized steps and again by searching the
+// summary, scrolling backwards, and expects the same title and text
+static void assert_rendered_matches_display(TransactionSummaryContext* ctx, size_t num_kinds) {
+    char title[TITLE_SIZE];
+    char text[TEXT_BUFFER_LENGTH];
+    const size_t step_count = ctx->step_count;
+
+    for (size_t flags = DisplayFlagNone; flags <= DisplayFlagAll; flags++) {
+        for (size_t i = num_kinds; i-- > 0;) {
+            ctx->step_count = 0;
+            assert(summary_context_display_item(ctx, i, flags) == 0);
+            memcpy(title, ctx->title, sizeof(title));
+            memcpy(text, ctx->text, sizeof(text));
+
+            ctx->step_count = step_count;
+            assert(summary_context_display_item(ctx, i, flags) == 0);
+            assert_string_equal(ctx->title, title);
+            assert_string_equal(ctx->text, text);
+        }
+    }
+}
+
+void test_summary_context_finalize_steps() {
+    TransactionSummaryContext ctx;
+    enum SummaryItemKind kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
+    size_t num_kinds = 0;
+    const Pubkey pubkey = {{BYTES32_BS58_2}};
+    const Hash hash = {{BYTES32_BS58_3}};
+    const char long_string[] = "a string that is longer than the text buffer can hold";
+    const SizedString sized_string = {4, "test"};
+    const Pubkey mint = {{PROGRAM_ID_SPL_TOKEN}};
+
+    summary_context_reset(&ctx);
+    summary_item_set_amount(summary_context_primary_item(&ctx), SummaryTitleTransfer, 1000000001);
+    summary_item_set_token_amount(summary_context_general_item(&ctx), SummaryTitleTransferTokens, 42, &mint, 1);
+    summary_item_set_i64(summary_context_general_item(&ctx), SummaryTitleEpoch, -42);
+    summary_item_set_u64(summary_context_general_item(&ctx), SummaryTitleCommission, 42);
+    summary_item_set_pubkey(summary_context_general_item(&ctx), SummaryTitleRecipient, &pubkey);
+    summary_item_set_hash(summary_context_general_item(&ctx), SummaryTitleHash, &hash);
+    summary_item_set_string(summary_context_general_item(&ctx), SummaryTitleSign, long_string);
+    summary_item_set_sized_string(summary_context_general_item(&ctx), SummaryTitleSeed, &sized_string);
+    summary_item_set_timestamp(summary_context_general_item(&ctx), SummaryTitleTime, 42);
+    summary_context_set_fee_payer_pubkey(&ctx, &pubkey);
+
+    assert(summary_context_finalize(&ctx, kinds, &num_kinds) == 0);
+    assert(num_kinds == 10);
+    assert(ctx.step_count == num_kinds);
+    assert_rendered_matches_display(&ctx, num_kinds);
+
+    // Steps map straight to their items
+    assert(summary_item_at(&ctx.summary, ctx.steps[0]) == &ctx.summary.primary);
+    assert(summary_item_at(&ctx.summary, ctx.steps[4]) == &ctx.summary.general[3]);
+    assert(summary_item_at(&ctx.summary, ctx.steps[num_kinds - 1]) == &ctx.summary.fee_payer);
+
+    assert(summary_context_display_item(&ctx, 0, DisplayFlagNone) == 0);
+    assert_string_equal(ctx.title, "Transfer");
+    assert_string_equal(ctx.text, "1.000000001 SOL");
+    assert(summary_context_display_item(&ctx, 4, DisplayFlagNone) == 0);
+    assert_string_equal(ctx.title, "Recipient");
+    assert_string_equal(ctx.text, "2222222..2222222");
+    assert(summary_context_display_item(&ctx, 4, DisplayFlagLongPubkeys) == 0);
+    assert_string_equal(ctx.text, "22222222222222222222222222222222222222222222");
+    assert(summary_context_display_item(&ctx, num_kinds, DisplayFlagNone) == 1);
+
+    // Setting another item drops the steps
+    assert(summary_context_general_item(&ctx) != NULL);
+    assert(ctx.step_count == 0);
+}
+
+void test_summary_context_finalize_all_general_items() {
+    TransactionSummaryContext ctx;
+    enum SummaryItemKind kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
+    size_t num_kinds = 0;
+    const Pubkey pubkey = {{BYTES32_BS58_4}};
+
+    summary_context_reset(&ctx);
+    summary_item_set_u64(summary_context_primary_item(&ctx), SummaryTitleTransfer, 42);
+    for (size_t i = 0; i < NUM_GENERAL_ITEMS; i++) {
+        summary_item_set_pubkey(summary_context_general_item(&ctx), SummaryTitleRecipient, &pubkey);
+    }
+    summary_context_set_fee_payer_pubkey(&ctx, &pubkey);
+
+    assert(summary_context_finalize(&ctx, kinds, &num_kinds) == 0);
+    assert(num_kinds == NUM_GENERAL_ITEMS + 2);
+    assert(summary_item_at(&ctx.summary, ctx.steps[NUM_GENERAL_ITEMS]) ==
+           &ctx.summary.general[NUM_GENERAL_ITEMS - 1]);
+    assert_rendered_matches_display(&ctx, num_kinds);
+}
+
+void test_summary_context_independent() {
+    TransactionSummaryContext a;
+    TransactionSummaryContext b;
+    summary_context_reset(&a);
+    summary_context_reset(&b);
+    transaction_summary_reset();
+
+    summary_item_set_string(summary_context_primary_item(&a), SummaryTitleSign, "A");
+    summary_item_set_u64(summary_context_general_item(&a), SummaryTitleSigners, 1);
+    summary_item_set_string(summary_context_primary_item(&b), SummaryTitleSign, "B");
+
+    // The global summary is untouched
+    assert(transaction_summary_primary_item() != NULL);
+
+    enum SummaryItemKind kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
+    size_t num_kinds = 0;
+    assert(summary_context_finalize(&a, kinds, &num_kinds) == 0);
+    assert(num_kinds == 2);
+    assert(summary_context_finalize(&b, kinds, &num_kinds) == 0);
+    assert(num_kinds == 1);
+    assert(transaction_summary_finalize(kinds, &num_kinds) == 1);
+
+    assert(summary_context_display_item(&a, 0, DisplayFlagNone) == 0);
+    assert(summary_context_display_item(&b, 0, DisplayFlagNone) == 0);
+    assert_string_equal(a.text, "A");
+    assert_string_equal(b.text, "B");
+    assert(strlen(G_transaction_summary_text) == 0);
+
+    assert(summary_context_display_item(&a, 1, DisplayFlagNone) == 0);
+    assert_string_equal(a.title, "Signers");
+    assert_string_equal(b.title, "Sign");
 }
 
 int main() {
+    test_summary_title_string();
     test_summary_item_setters();
     test_summary_item_as_unused();
 
@@ -382,6 +539,9 @@ int main() {
     test_transaction_summary_update_display_for_item();
     test_transaction_summary_display_item();
     test_transaction_summary_finalize();
+    test_summary_context_independent();
+    test_summary_context_finalize_steps();
+    test_summary_context_finalize_all_general_items();
 
     test_repro_unrecognized_format_reverse_nav_hash_corruption_bug();
 
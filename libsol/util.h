@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <string.h>
 
 #define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
@@ -7,6 +8,8 @@
         int err = x;         \
         if (err) return err; \
     } while (0)
+// Bytes of `type` up to and including `member`
+#define MEMBER_END(type, member) (offsetof(type, member) + sizeof(((type*) 0)->member))
 #define MIN(a, b) ((a) < (b) ? (a) : (b));
 
 #define assert_string_equal(actual, expected) assert(strcmp(actual, expected) == 0)
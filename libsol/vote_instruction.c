@@ -7,7 +7,7 @@
 
 const Pubkey vote_program_id = {{PROGRAM_ID_VOTE}};
 
-static int parse_vote_instruction_kind(Parser* parser, enum VoteInstructionKind* kind) {
+int parse_vote_instruction_kind(Parser* parser, enum VoteInstructionKind* kind) {
     uint32_t maybe_kind;
     BAIL_IF(parse_u32(parser, &maybe_kind));
     switch (maybe_kind) {
@@ -25,9 +25,7 @@ static int parse_vote_instruction_kind(Parser* parser, enum VoteInstructionKind*
     return 1;
 }
 
-static int parse_vote_authorize(Parser* parser, enum VoteAuthorize* authorize) {
-    uint32_t maybe_authorize;
-    BAIL_IF(parse_u32(parser, &maybe_authorize));
+static int vote_authorize_from_u32(uint32_t maybe_authorize, enum VoteAuthorize* authorize) {
     switch (maybe_authorize) {
         case VoteAuthorizeVoter:
         case VoteAuthorizeWithdrawer:
@@ -37,6 +35,12 @@ static int parse_vote_authorize(Parser* parser, enum VoteAuthorize* authorize) {
     return 1;
 }
 
+static int parse_vote_authorize(Parser* parser, enum VoteAuthorize* authorize) {
+    uint32_t maybe_authorize;
+    BAIL_IF(parse_u32(parser, &maybe_authorize));
+    return vote_authorize_from_u32(maybe_authorize, authorize);
+}
+
 static int parse_vote_initialize_instruction(Parser* parser,
                                              const Instruction* instruction,
                                              const MessageHeader* header,
@@ -50,12 +54,12 @@ static int parse_vote_initialize_instruction(Parser* parser,
     // Skip clock sysvar
     BAIL_IF(instruction_accounts_iterator_next(&it, NULL));
 
-    BAIL_IF(parse_pubkey(parser, &info->vote_init.validator_id));
-    BAIL_IF(parse_pubkey(parser, &info->vote_init.vote_authority));
-    BAIL_IF(parse_pubkey(parser, &info->vote_init.withdraw_authority));
-    uint8_t commission;
-    BAIL_IF(parse_u8(parser, &commission));
-    info->vote_init.commission = commission;
+    Record record;
+    BAIL_IF(parse_record(parser, PUBKEY_SIZE * 3 + sizeof(uint8_t), &record));
+    info->vote_init.validator_id = record_pubkey(&record);
+    info->vote_init.vote_authority = record_pubkey(&record);
+    info->vote_init.withdraw_authority = record_pubkey(&record);
+    info->vote_init.commission = record_u8(&record);
 
     return 0;
 }
@@ -88,8 +92,10 @@ static int parse_vote_authorize_instruction(Parser* parser,
     BAIL_IF(instruction_accounts_iterator_next(&it, NULL));
     BAIL_IF(instruction_accounts_iterator_next(&it, &info->authority));
 
-    BAIL_IF(parse_pubkey(parser, &info->new_authority));
-    BAIL_IF(parse_vote_authorize(parser, &info->authorize));
+    Record record;
+    BAIL_IF(parse_record(parser, PUBKEY_SIZE + sizeof(uint32_t), &record));
+    info->new_authority = record_pubkey(&record);
+    BAIL_IF(vote_authorize_from_u32(record_u32(&record), &info->authorize));
 
     return 0;
 }
@@ -194,21 +200,42 @@ int parse_vote_instructions(const Instruction* instruction,
     return 1;
 }
 
+size_t vote_info_size(const VoteInfo* info) {
+    switch (info->kind) {
+        case VoteInitialize:
+            return MEMBER_END(VoteInfo, initialize);
+        case VoteWithdraw:
+            return MEMBER_END(VoteInfo, withdraw);
+        case VoteAuthorize:
+        case VoteAuthorizeChecked:
+            return MEMBER_END(VoteInfo, authorize);
+        case VoteUpdateValidatorId:
+            return MEMBER_END(VoteInfo, update_validator_id);
+        case VoteUpdateCommission:
+            return MEMBER_END(VoteInfo, update_commission);
+        case VoteVote:
+        case VoteSwitchVote:
+            break;
+    }
+
+    return sizeof(VoteInfo);
+}
+
 static int print_vote_withdraw_info(const VoteWithdrawInfo* info, const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_amount(item, "Vote withdraw", info->lamports);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_amount(item, SummaryTitleVoteWithdraw, info->lamports);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "From", info->account);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleFrom, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "To", info->to);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleTo, info->to);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -216,27 +243,27 @@ static int print_vote_withdraw_info(const VoteWithdrawInfo* info, const PrintCon
 
 static int print_vote_authorize_info(const VoteAuthorizeInfo* info,
                                      const PrintConfig* print_config) {
-    const char* new_authority_title = NULL;
+    enum SummaryTitle new_authority_title = SummaryTitleNone;
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Set vote auth", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleSetVoteAuth, info->account);
 
     switch (info->authorize) {
         case VoteAuthorizeVoter:
-            new_authority_title = "New vote auth";
+            new_authority_title = SummaryTitleNewVoteAuth;
             break;
         case VoteAuthorizeWithdrawer:
-            new_authority_title = "New withdraw auth";
+            new_authority_title = SummaryTitleNewWithdrawAuth;
             break;
     }
 
-    item = transaction_summary_general_item();
+    item = summary_context_general_item(print_config->summary);
     summary_item_set_pubkey(item, new_authority_title, info->new_authority);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -246,15 +273,15 @@ static int print_vote_update_validator_id_info(const VoteUpdateValidatorIdInfo*
                                                const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Update validator", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleUpdateValidator, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "New validator ID", info->new_validator_id);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleNewValidatorID, info->new_validator_id);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -264,15 +291,15 @@ static int print_vote_update_commission_info(const VoteUpdateCommissionInfo* inf
                                              const PrintConfig* print_config) {
     SummaryItem* item;
 
-    item = transaction_summary_primary_item();
-    summary_item_set_pubkey(item, "Update commission", info->account);
+    item = summary_context_primary_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleUpdateCommission, info->account);
 
-    item = transaction_summary_general_item();
-    summary_item_set_u64(item, "Commission", info->commission);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_u64(item, SummaryTitleCommission, info->commission);
 
     if (print_config_show_authority(print_config, info->authority)) {
-        item = transaction_summary_general_item();
-        summary_item_set_pubkey(item, "Authorized by", info->authority);
+        item = summary_context_general_item(print_config->summary);
+        summary_item_set_pubkey(item, SummaryTitleAuthorizedBy, info->authority);
     }
 
     return 0;
@@ -281,7 +308,9 @@ static int print_vote_update_commission_info(const VoteUpdateCommissionInfo* inf
 int print_vote_info(const VoteInfo* info, const PrintConfig* print_config) {
     switch (info->kind) {
         case VoteInitialize:
-            return print_vote_initialize_info("Init vote acct", &info->initialize, print_config);
+            return print_vote_initialize_info(SummaryTitleInitVoteAcct,
+                                              &info->initialize,
+                                              print_config);
         case VoteWithdraw:
             return print_vote_withdraw_info(&info->withdraw, print_config);
         case VoteAuthorize:
@@ -299,28 +328,28 @@ int print_vote_info(const VoteInfo* info, const PrintConfig* print_config) {
     return 1;
 }
 
-int print_vote_initialize_info(const char* primary_title,
+int print_vote_initialize_info(enum SummaryTitle primary_title,
                                const VoteInitializeInfo* info,
                                const PrintConfig* print_config) {
     UNUSED(print_config);
 
     SummaryItem* item;
-    if (primary_title != NULL) {
-        item = transaction_summary_primary_item();
+    if (primary_title != SummaryTitleNone) {
+        item = summary_context_primary_item(print_config->summary);
         summary_item_set_pubkey(item, primary_title, info->account);
     }
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "Validator ID", info->vote_init.validator_id);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleValidatorID, info->vote_init.validator_id);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "New vote auth", info->vote_init.vote_authority);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleNewVoteAuth, info->vote_init.vote_authority);
 
-    item = transaction_summary_general_item();
-    summary_item_set_pubkey(item, "New withdraw auth", info->vote_init.withdraw_authority);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_pubkey(item, SummaryTitleNewWithdrawAuth, info->vote_init.withdraw_authority);
 
-    item = transaction_summary_general_item();
-    summary_item_set_u64(item, "Commission", info->vote_init.commission);
+    item = summary_context_general_item(print_config->summary);
+    summary_item_set_u64(item, SummaryTitleCommission, info->vote_init.commission);
 
     return 0;
 }
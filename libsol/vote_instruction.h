@@ -70,10 +70,12 @@ typedef struct VoteInfo {
     };
 } VoteInfo;
 
+int parse_vote_instruction_kind(Parser* parser, enum VoteInstructionKind* kind);
 int parse_vote_instructions(const Instruction* instruction,
                             const MessageHeader* header,
                             VoteInfo* info);
+size_t vote_info_size(const VoteInfo* info);
 int print_vote_info(const VoteInfo* info, const PrintConfig* print_config);
-int print_vote_initialize_info(const char* primary_title,
+int print_vote_initialize_info(enum SummaryTitle primary_title,
                                const VoteInitializeInfo* info,
                                const PrintConfig* print_config);
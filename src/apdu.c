@@ -1,5 +1,7 @@
 #include "apdu.h"
 #include "utils.h"
+#include "signer_key.h"
+#include "sol/message.h"
 
 /**
  * Deserialize APDU into ApduCommand structure.
@@ -64,24 +66,38 @@ int apdu_handle_message(const uint8_t* apdu_message,
         }
         case InsGetAppConfiguration:
         case InsGetPubkey:
+        case InsGetPubkeys:
         case InsSignMessage:
-        case InsSignOffchainMessage: {
+        case InsSignOffchainMessage:
+        case InsSignBatchAdd:
+        case InsSignBatchReview:
+        case InsSignBatchSign:
+        case InsResendSignature: {
             // must at least hold a full modern header
             if (apdu_message_len < OFFSET_CDATA) {
                 return ApduReplySolanaInvalidMessageSize;
             }
-            // modern data may be up to 255B
-            if (apdu_message_len > UINT8_MAX + OFFSET_CDATA) {
-                return ApduReplySolanaInvalidMessageSize;
+            size_t offset_cdata = OFFSET_CDATA;
+            if (apdu_message[OFFSET_LC] == 0 && apdu_message_len > OFFSET_CDATA) {
+                // extended framing, a zero Lc is followed by a 16-bit length
+                if (apdu_message_len < EXTENDED_OFFSET_CDATA) {
+                    return ApduReplySolanaInvalidMessageSize;
+                }
+                header.data_length = U2BE(apdu_message, OFFSET_CDATA);
+                offset_cdata = EXTENDED_OFFSET_CDATA;
+            } else {
+                // short data may be up to 255B
+                if (apdu_message_len > UINT8_MAX + OFFSET_CDATA) {
+                    return ApduReplySolanaInvalidMessageSize;
+                }
+                header.data_length = apdu_message[OFFSET_LC];
             }
-
-            header.data_length = apdu_message[OFFSET_LC];
-            if (apdu_message_len != header.data_length + OFFSET_CDATA) {
+            if (apdu_message_len != header.data_length + offset_cdata) {
                 return ApduReplySolanaInvalidMessageSize;
             }
 
             if (header.data_length > 0) {
-                header.data = apdu_message + OFFSET_CDATA;
+                header.data = apdu_message + offset_cdata;
             }
 
             header.deprecated_host = false;
@@ -97,9 +113,32 @@ int apdu_handle_message(const uint8_t* apdu_message,
     // P2_EXTEND is set to signal that this APDU buffer extends, rather
     // than replaces, the current message buffer
     const bool first_data_chunk = !(header.p2 & P2_EXTEND);
+    // the data of these commands accumulates into a message over several chunks
+    const bool message_upload =
+        header.instruction == InsDeprecatedSignMessage || header.instruction == InsSignMessage ||
+        header.instruction == InsSignOffchainMessage || header.instruction == InsSignBatchAdd ||
+        header.instruction == InsSignBatchSign;
+    // P2_COMPRESSED is set when the transaction message is uploaded in the
+    // compressed encoding, see sol/compressed_message.h
+    const bool compressed = header.p2 & P2_COMPRESSED;
+    if (compressed && header.instruction != InsSignMessage &&
+        header.instruction != InsSignBatchAdd && header.instruction != InsSignBatchSign) {
+        return ApduReplySdkNotSupported;
+    }
+    // P2_OFFSET is set on every chunk of a resumable upload
+    const bool resumable = header.p2 & P2_OFFSET;
+    if (resumable && (!message_upload || header.deprecated_host)) {
+        return ApduReplySdkNotSupported;
+    }
+
+    // The signer key derived ahead for an upload is only kept for its next
+    // chunks. Any other command drops it
+    if (!message_upload || first_data_chunk) {
+        signer_key_clear();
+    }
 
     if (header.instruction == InsDeprecatedGetAppConfiguration ||
-        header.instruction == InsGetAppConfiguration) {
+        header.instruction == InsGetAppConfiguration || header.instruction == InsSignBatchReview) {
         // return early if no data is expected for the command
         explicit_bzero(apdu_command, sizeof(ApduCommand));
         apdu_command->state = ApduStatePayloadComplete;
@@ -107,50 +146,81 @@ int apdu_handle_message(const uint8_t* apdu_message,
         apdu_command->non_confirm = (header.p1 == P1_NON_CONFIRM);
         apdu_command->deprecated_host = header.deprecated_host;
         return 0;
-    } else if (header.instruction == InsDeprecatedSignMessage ||
-               header.instruction == InsSignMessage ||
-               header.instruction == InsSignOffchainMessage) {
+    } else if (message_upload) {
         if (!first_data_chunk) {
             // validate the command in progress
             if (apdu_command->state != ApduStatePayloadInProgress ||
                 apdu_command->instruction != header.instruction ||
                 apdu_command->non_confirm != (header.p1 == P1_NON_CONFIRM) ||
                 apdu_command->deprecated_host != header.deprecated_host ||
-                apdu_command->num_derivation_paths != 1) {
+                apdu_command->compressed != compressed ||
+                apdu_command->resumable != resumable ||
+                apdu_command->num_derivation_paths == 0) {
+                signer_key_clear();
                 return ApduReplySolanaInvalidMessage;
             }
+            if (resumable) {
+                // The data is preceded by its offset in the upload. A chunk
+                // resent because its reply was lost overlaps what has been
+                // received, that part is skipped. A gap is refused without
+                // changing the command, and the host resumes from
+                // received_length
+                if (header.data_length < 2) {
+                    return ApduReplySolanaInvalidMessageSize;
+                }
+                const size_t offset = U2BE(header.data, 0);
+                header.data += 2;
+                header.data_length -= 2;
+                if (offset > apdu_command->received_length ||
+                    apdu_command->received_length - offset > header.data_length) {
+                    return ApduReplySolanaUnexpectedOffset;
+                }
+                header.data += apdu_command->received_length - offset;
+                header.data_length -= apdu_command->received_length - offset;
+            }
         } else {
             explicit_bzero(apdu_command, sizeof(ApduCommand));
+            cx_sha256_init(&apdu_command->message_hash_context);
         }
     } else {
         explicit_bzero(apdu_command, sizeof(ApduCommand));
     }
 
-    // read derivation path
-    if (first_data_chunk) {
-        if (!header.deprecated_host && header.instruction != InsGetPubkey) {
+    // read derivation path, the message hash of RESEND_SIGNATURE comes alone
+    if (first_data_chunk && header.instruction != InsResendSignature) {
+        if (!header.deprecated_host && header.instruction != InsGetPubkey &&
+            header.instruction != InsGetPubkeys) {
             if (!header.data_length) {
                 return ApduReplySolanaInvalidMessageSize;
             }
             apdu_command->num_derivation_paths = header.data[0];
             header.data++;
             header.data_length--;
-            // We only support one derivation path ATM
-            if (apdu_command->num_derivation_paths != 1) {
+            // Only transaction messages may have several signers
+            const size_t max_derivation_paths =
+                header.instruction == InsSignMessage ? MAX_DERIVATION_PATHS : 1;
+            if (apdu_command->num_derivation_paths < 1 ||
+                apdu_command->num_derivation_paths > max_derivation_paths) {
                 return ApduReplySolanaInvalidMessage;
             }
         } else {
             apdu_command->num_derivation_paths = 1;
         }
-        const int ret = read_derivation_path(header.data,
-                                             header.data_length,
-                                             apdu_command->derivation_path,
-                                             &apdu_command->derivation_path_length);
-        if (ret) {
-            return ret;
+        for (size_t i = 0; i < apdu_command->num_derivation_paths; i++) {
+            const int ret = read_derivation_path(header.data,
+                                                 header.data_length,
+                                                 apdu_command->derivation_paths[i],
+                                                 &apdu_command->derivation_path_lengths[i]);
+            if (ret) {
+                return ret;
+            }
+            header.data += 1 + apdu_command->derivation_path_lengths[i] * 4;
+            header.data_length -= 1 + apdu_command->derivation_path_lengths[i] * 4;
         }
-        header.data += 1 + apdu_command->derivation_path_length * 4;
-        header.data_length -= 1 + apdu_command->derivation_path_length * 4;
+        // only the message that follows the derivation paths is compressed
+        apdu_command->compressed = compressed;
+        compressed_message_decoder_init(&apdu_command->decoder);
+        apdu_command->resumable = resumable;
     }
 
     apdu_command->state = ApduStatePayloadInProgress;
@@ -172,7 +242,22 @@ int apdu_handle_message(const uint8_t* apdu_message,
         }
     }
 
-    if (header.data) {
+    const size_t chunk_offset = apdu_command->message_length;
+    if (header.data && apdu_command->compressed) {
+        size_t message_length = apdu_command->message_length;
+        if (compressed_message_expand(&apdu_command->decoder,
+                                      header.data,
+                                      header.data_length,
+                                      apdu_command->message,
+                                      MAX_MESSAGE_LENGTH,
+                                      &message_length)) {
+            return ApduReplySolanaInvalidMessage;
+        }
+        apdu_command->message_length = message_length;
+        if (!(header.p2 & P2_MORE) && compressed_message_finish(&apdu_command->decoder)) {
+            return ApduReplySolanaInvalidMessage;
+        }
+    } else if (header.data) {
         if (apdu_command->message_length + header.data_length > MAX_MESSAGE_LENGTH) {
             return ApduReplySolanaInvalidMessageSize;
         }
@@ -184,6 +269,34 @@ int apdu_handle_message(const uint8_t* apdu_message,
     } else if (header.instruction != InsDeprecatedGetPubkey && header.instruction != InsGetPubkey) {
         return ApduReplySolanaInvalidMessageSize;
     }
+    if (header.data) {
+        apdu_command->received_length += header.data_length;
+    }
+
+    // hash the message as it arrives, so that the hash is ready as soon as
+    // the last chunk is
+    if (message_upload) {
+        cx_hash((cx_hash_t*) &apdu_command->message_hash_context,
+                0,
+                apdu_command->message + chunk_offset,
+                apdu_command->message_length - chunk_offset,
+                NULL,
+                0);
+    }
+
+    // decode as much of the transaction message as has been received so far
+    if (header.instruction == InsDeprecatedSignMessage || header.instruction == InsSignMessage ||
+        header.instruction == InsSignBatchAdd) {
+        if (first_data_chunk) {
+            message_stream_reset();
+        }
+        const bool last_data_chunk = !(header.p2 & P2_MORE);
+        if (message_stream_update(apdu_command->message,
+                                  apdu_command->message_length,
+                                  last_data_chunk) == MessageStreamInvalid) {
+            return ApduReplySolanaInvalidMessage;
+        }
+    }
 
     // check if more data is expected
     if (header.p2 & P2_MORE) {
@@ -191,6 +304,14 @@ int apdu_handle_message(const uint8_t* apdu_message,
     }
 
     apdu_command->state = ApduStatePayloadComplete;
+    if (message_upload) {
+        cx_hash((cx_hash_t*) &apdu_command->message_hash_context,
+                CX_LAST,
+                NULL,
+                0,
+                (uint8_t*) &apdu_command->message_hash,
+                HASH_LENGTH);
+    }
 
     return 0;
 }
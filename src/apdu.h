@@ -3,8 +3,10 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "cx.h"
 #include "globals.h"
 #include "sol/parser.h"
+#include "sol/compressed_message.h"
 
 typedef enum ApduState {
     ApduStateUninitialized = 0,
@@ -43,6 +45,7 @@ typedef enum ApduReply {
     ApduReplySolanaInvalidMessageHeader = 0x6a81,
     ApduReplySolanaInvalidMessageFormat = 0x6a82,
     ApduReplySolanaInvalidMessageSize = 0x6a83,
+    ApduReplySolanaUnexpectedOffset = 0x6a84,
     ApduReplySolanaSummaryFinalizeFailed = 0x6f00,
     ApduReplySolanaSummaryUpdateFailed = 0x6f01,
 
@@ -52,6 +55,21 @@ typedef enum ApduReply {
     ApduReplySuccess = 0x9000,
 } ApduReply;
 
+// Features reported by GET_APP_CONFIGURATION
+typedef enum AppCapability {
+    // Data longer than 255B, framed with a zero Lc and a 16-bit length
+    AppCapabilityExtendedApdu = 1 << 0,
+    AppCapabilityGetPubkeys = 1 << 1,
+    AppCapabilitySignBatch = 1 << 2,
+    AppCapabilityMultipleSigners = 1 << 3,
+    // Transaction messages uploaded with P2_COMPRESSED
+    AppCapabilityCompressedUpload = 1 << 4,
+    // Chunks uploaded with P2_OFFSET, resumed after a lost chunk or reply
+    AppCapabilityResumableUpload = 1 << 5,
+    // Last signatures returned again by RESEND_SIGNATURE while fresh
+    AppCapabilityResendSignature = 1 << 6,
+} AppCapability;
+
 typedef struct ApduHeader {
     uint8_t class;
     uint8_t instruction;
@@ -66,12 +84,25 @@ typedef struct ApduCommand {
     ApduState state;
     InstructionCode instruction;
     uint8_t num_derivation_paths;
-    uint32_t derivation_path[MAX_BIP32_PATH_LENGTH];
-    uint32_t derivation_path_length;
+    // One path per signer. Only SIGN_MESSAGE takes more than one
+    uint32_t derivation_paths[MAX_DERIVATION_PATHS][MAX_BIP32_PATH_LENGTH];
+    uint32_t derivation_path_lengths[MAX_DERIVATION_PATHS];
     bool non_confirm;
     bool deprecated_host;
+    // The message is uploaded in the compressed encoding and expanded as
+    // its chunks arrive
+    bool compressed;
+    CompressedMessageDecoder decoder;
+    // The chunks after the first one start with the offset of their data,
+    // see apdu_handle_message()
+    bool resumable;
+    // Data bytes received after the derivation paths, as uploaded
+    size_t received_length;
     uint8_t message[MAX_MESSAGE_LENGTH];
     int message_length;
+    // Running hash of the message, final in message_hash once the payload is
+    // complete
+    cx_sha256_t message_hash_context;
     Hash message_hash;
 } ApduCommand;
 
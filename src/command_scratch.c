@@ -0,0 +1,18 @@
+#include "command_scratch.h"
+#include "utils.h"
+
+CommandScratch G_command_scratch;
+
+void command_scratch_claim(size_t view_size) {
+    if (view_size > sizeof(CommandScratchView)) {
+        THROW(ApduReplySdkExceptionOverflow);
+    }
+    command_scratch_reset();
+    G_command_scratch.watermark = view_size;
+}
+
+void command_scratch_reset(void) {
+    explicit_bzero(&G_command_scratch.view, G_command_scratch.watermark);
+    G_command_scratch.watermark = 0;
+    G_command_scratch.generation++;
+}
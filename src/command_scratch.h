@@ -0,0 +1,84 @@
+#include "os.h"
+#include "ux.h"
+#include "globals.h"
+#include "sol/parser.h"
+#include "sol/message.h"
+#include "instruction.h"
+#include "sol/printer.h"
+#include "sol/transaction_summary.h"
+#include "signBatch.h"
+
+#ifndef _COMMAND_SCRATCH_H_
+#define _COMMAND_SCRATCH_H_
+
+// Summary steps, then approve, reject and FLOW_END_STEP
+#define MAX_SIGN_MESSAGE_FLOW_STEPS (MAX_TRANSACTION_SUMMARY_ITEMS + 3)
+// Summary steps, then message text, approve, reject and FLOW_END_STEP
+#define MAX_SIGN_OFFCHAIN_MESSAGE_FLOW_STEPS (MAX_TRANSACTION_SUMMARY_ITEMS + 4)
+
+typedef struct GetPubkeyScratch {
+    uint8_t public_key[PUBKEY_LENGTH];
+    char public_key_str[BASE58_PUBKEY_LENGTH];
+} GetPubkeyScratch;
+
+// The decoded instructions are only needed until the summary is printed,
+// before the flow is built
+typedef struct SignMessageScratch {
+    union {
+        _Alignas(uint64_t) uint8_t instruction_arena[MESSAGE_STREAM_ARENA_SIZE];
+        ux_flow_step_t const *flow_steps[MAX_SIGN_MESSAGE_FLOW_STEPS];
+    };
+} SignMessageScratch;
+
+typedef struct SignOffchainMessageScratch {
+    ux_flow_step_t const *flow_steps[MAX_SIGN_OFFCHAIN_MESSAGE_FLOW_STEPS];
+} SignOffchainMessageScratch;
+
+// Claimed by the first SIGN_BATCH_ADD, kept until the review is done
+typedef struct SignBatchScratch {
+    size_t step_count;
+    SignBatchStep steps[MAX_SIGN_BATCH_STEPS];
+    // Step titles and texts, NUL terminated and back to back
+    size_t arena_used;
+    char arena[SIGN_BATCH_ARENA_SIZE];
+    // Each added message is decoded and printed before the review flow is
+    // built
+    union {
+        _Alignas(uint64_t) uint8_t instruction_arena[MESSAGE_STREAM_ARENA_SIZE];
+        ux_flow_step_t const *flow_steps[MAX_SIGN_BATCH_FLOW_STEPS];
+    };
+} SignBatchScratch;
+
+// State of the command being handled, kept until its UX flow is done. Only
+// one command runs at a time, so the handlers share a single buffer, each
+// through its own view.
+//
+// G_command.message stays out: it is filled chunk by chunk before the handler
+// claims a view, and a batch keeps its view while the next messages come in.
+// The summary context stays out too: every signing view needs it alongside its
+// flow steps, so it could only share the GET_PUBKEY bytes
+typedef union CommandScratchView {
+    GetPubkeyScratch get_pubkey;
+    SignMessageScratch sign_message;
+    SignOffchainMessageScratch sign_offchain_message;
+    SignBatchScratch sign_batch;
+} CommandScratchView;
+
+typedef struct CommandScratch {
+    // Bytes of `view` that may have been written since the last clear
+    size_t watermark;
+    // Incremented by every clear, so that a view kept across several commands
+    // can tell whether another command took the buffer in between
+    uint32_t generation;
+    CommandScratchView view;
+} CommandScratch;
+
+extern CommandScratch G_command_scratch;
+
+// Clears what the previous command left and hands `view_size` bytes over to
+// the running one
+void command_scratch_claim(size_t view_size);
+
+void command_scratch_reset(void);
+
+#endif
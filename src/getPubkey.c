@@ -1,17 +1,13 @@
 #include "apdu.h"
+#include "command_scratch.h"
 #include "getPubkey.h"
 #include "os.h"
 #include "ux.h"
 #include "utils.h"
 #include "sol/printer.h"
 
-static uint8_t G_publicKey[PUBKEY_LENGTH];
-static char G_publicKeyStr[BASE58_PUBKEY_LENGTH];
-
-void reset_getpubkey_globals(void) {
-    MEMCLEAR(G_publicKey);
-    MEMCLEAR(G_publicKeyStr);
-}
+#define G_publicKey    (G_command_scratch.view.get_pubkey.public_key)
+#define G_publicKeyStr (G_command_scratch.view.get_pubkey.public_key_str)
 
 static uint8_t set_result_get_pubkey() {
     memcpy(G_io_apdu_buffer, G_publicKey, PUBKEY_LENGTH);
@@ -54,7 +50,10 @@ void handle_get_pubkey(volatile unsigned int *flags, volatile unsigned int *tx)
         THROW(ApduReplySdkInvalidParameter);
     }
 
-    get_public_key(G_publicKey, G_command.derivation_path, G_command.derivation_path_length);
+    command_scratch_claim(sizeof(GetPubkeyScratch));
+    get_public_key(G_publicKey,
+                   G_command.derivation_paths[0],
+                   G_command.derivation_path_lengths[0]);
     encode_base58(G_publicKey, PUBKEY_LENGTH, G_publicKeyStr, BASE58_PUBKEY_LENGTH);
 
     if (G_command.non_confirm) {
@@ -65,3 +64,56 @@ void handle_get_pubkey(volatile unsigned int *flags, volatile unsigned int *tx)
         *flags |= IO_ASYNCH_REPLY;
     }
 }
+
+#define GET_PUBKEYS_MESSAGE_LENGTH 2
+// Each pubkey not cached costs a derivation, so this bounds the time spent on
+// one response, the same on every device. Only the last PUBKEY_CACHE_ENTRIES
+// of a range stay in the RAM cache
+#define MAX_PUBKEYS_PER_RESPONSE 8
+// The count of returned pubkeys, the pubkeys, then the status word
+_Static_assert(1 + MAX_PUBKEYS_PER_RESPONSE * PUBKEY_LENGTH + 2 <= sizeof(G_io_apdu_buffer),
+               "GET_PUBKEYS response does not fit the APDU buffer");
+
+void handle_get_pubkeys(volatile unsigned int *tx) {
+    if (!tx || G_command.instruction != InsGetPubkeys ||
+        G_command.state != ApduStatePayloadComplete) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+
+    if (!G_command.non_confirm) {
+        // There is no review of several pubkeys
+        THROW(ApduReplySdkNotSupported);
+    }
+
+    if (G_command.message_length != GET_PUBKEYS_MESSAGE_LENGTH) {
+        THROW(ApduReplySolanaInvalidMessageSize);
+    }
+    const uint8_t index_position = G_command.message[0];
+    const uint8_t count = G_command.message[1];
+    if (index_position >= G_command.derivation_path_lengths[0] || count == 0) {
+        THROW(ApduReplySolanaInvalidMessage);
+    }
+
+    uint32_t derivation_path[MAX_BIP32_PATH_LENGTH];
+    memcpy(derivation_path, G_command.derivation_paths[0], sizeof(derivation_path));
+    const uint32_t first_index = derivation_path[index_position];
+    // The incremented component keeps the hardened bit of the first one
+    const uint32_t hardened = first_index & 0x80000000;
+    const uint32_t last_index = first_index + (count - 1);
+    if ((last_index & 0x80000000) != hardened) {
+        THROW(ApduReplySolanaInvalidMessage);
+    }
+
+    // The host asks again for the rest, starting after the last one returned
+    const size_t num_pubkeys = count < MAX_PUBKEYS_PER_RESPONSE ? count : MAX_PUBKEYS_PER_RESPONSE;
+    for (size_t i = 0; i < num_pubkeys; i++) {
+        derivation_path[index_position] = first_index + i;
+        get_public_key(G_io_apdu_buffer + 1 + i * PUBKEY_LENGTH,
+                       derivation_path,
+                       G_command.derivation_path_lengths[0]);
+    }
+    G_io_apdu_buffer[0] = num_pubkeys;
+
+    *tx = 1 + num_pubkeys * PUBKEY_LENGTH;
+    THROW(ApduReplySuccess);
+}
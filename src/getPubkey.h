@@ -5,8 +5,16 @@
 #ifndef _GET_PUBKEY_H_
 #define _GET_PUBKEY_H_
 
-void reset_getpubkey_globals(void);
-
 void handle_get_pubkey(volatile unsigned int *flags, volatile unsigned int *tx);
 
+/**
+ * Returns the pubkeys of consecutive derivation paths, without confirmation.
+ *
+ * The derivation path of the command is the one of the first key. Its message
+ * holds the position of the path component to increment and the number of
+ * keys wanted. As many keys as fit in the response are returned, the host
+ * asks for the rest starting from the first key not returned.
+ */
+void handle_get_pubkeys(volatile unsigned int *tx);
+
 #endif
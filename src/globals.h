@@ -15,12 +15,15 @@
 #define OFFSET_LC               4
 #define OFFSET_CDATA            5
 #define DEPRECATED_OFFSET_CDATA 6
+#define EXTENDED_OFFSET_CDATA   7
 
 #define P1_CONFIRM     0x01
 #define P1_NON_CONFIRM 0x00
 
-#define P2_EXTEND 0x01
-#define P2_MORE   0x02
+#define P2_EXTEND     0x01
+#define P2_MORE       0x02
+#define P2_COMPRESSED 0x04
+#define P2_OFFSET     0x08
 
 #define ROUND_TO_NEXT(x, next) (((x) == 0) ? 0 : ((((x - 1) / (next)) + 1) * (next)))
 
@@ -29,6 +32,8 @@
 
 #define MAX_BIP32_PATH_LENGTH             5
 #define MAX_DERIVATION_PATH_BUFFER_LENGTH (1 + MAX_BIP32_PATH_LENGTH * 4)
+// Signers of a SIGN_MESSAGE command, their signatures must fit one response
+#define MAX_DERIVATION_PATHS 3
 #define TOTAL_SIGN_MESSAGE_BUFFER_LENGTH  (PACKET_DATA_SIZE + MAX_DERIVATION_PATH_BUFFER_LENGTH)
 
 #define MAX_MESSAGE_LENGTH ROUND_TO_NEXT(TOTAL_SIGN_MESSAGE_BUFFER_LENGTH, USB_SEGMENT_SIZE)
@@ -49,7 +54,12 @@ typedef enum InstructionCode {
     InsGetAppConfiguration = 0x04,
     InsGetPubkey = 0x05,
     InsSignMessage = 0x06,
-    InsSignOffchainMessage = 0x07
+    InsSignOffchainMessage = 0x07,
+    InsGetPubkeys = 0x08,
+    InsSignBatchAdd = 0x09,
+    InsSignBatchReview = 0x0a,
+    InsSignBatchSign = 0x0b,
+    InsResendSignature = 0x0c
 } InstructionCode;
 
 extern volatile bool G_called_from_swap;
@@ -80,9 +90,28 @@ typedef struct AppSettings {
     uint8_t display_mode;
 } AppSettings;
 
+typedef struct PubkeyCacheEntry {
+    uint32_t derivation_path[MAX_BIP32_PATH_LENGTH];
+    // 0 when the entry is unused
+    uint8_t derivation_path_length;
+    uint8_t public_key[PUBKEY_LENGTH];
+} PubkeyCacheEntry;
+
+// Accounts 44'/540'/0' to 44'/540'/(NV_PUBKEY_CACHE_ACCOUNTS - 1)' have their
+// public key kept in NVRAM, one entry each
+#define NV_PUBKEY_CACHE_ACCOUNTS 8
+
+typedef struct NvPubkeyCache {
+    // Public key of 44'/540', tells which seed the entries were derived from.
+    // All zeros until the cache is first used
+    uint8_t seed_fingerprint[PUBKEY_LENGTH];
+    PubkeyCacheEntry entries[NV_PUBKEY_CACHE_ACCOUNTS];
+} NvPubkeyCache;
+
 typedef struct internalStorage_t {
     AppSettings settings;
     uint8_t initialized;
+    NvPubkeyCache pubkey_cache;
 } internalStorage_t;
 
 extern const internalStorage_t N_storage_real;
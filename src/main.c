@@ -16,9 +16,14 @@
  ********************************************************************************/
 
 #include "utils.h"
+#include "command_scratch.h"
+#include "pubkey_cache.h"
+#include "signer_key.h"
 #include "getPubkey.h"
 #include "signMessage.h"
 #include "signOffchainMessage.h"
+#include "signBatch.h"
+#include "signature_cache.h"
 #include "apdu.h"
 #include "menu.h"
 
@@ -38,6 +43,31 @@ static void reset_main_globals(void) {
     MEMCLEAR(G_io_seproxyhal_spi_buffer);
 }
 
+// Longest APDU data the IO buffer can receive
+#define MAX_APDU_DATA_LENGTH                                \
+    (sizeof(G_io_apdu_buffer) > UINT8_MAX + OFFSET_CDATA    \
+         ? sizeof(G_io_apdu_buffer) - EXTENDED_OFFSET_CDATA \
+         : UINT8_MAX)
+
+// Offset the upload in progress resumes from, returned by the chunks of a
+// resumable upload
+static uint8_t set_result_upload_offset(void) {
+    G_io_apdu_buffer[0] = G_command.received_length >> 8;
+    G_io_apdu_buffer[1] = G_command.received_length & 0xff;
+    return 2;
+}
+
+static uint8_t app_capabilities(void) {
+    uint8_t capabilities =
+        AppCapabilityGetPubkeys | AppCapabilitySignBatch | AppCapabilityMultipleSigners |
+        AppCapabilityCompressedUpload | AppCapabilityResumableUpload |
+        AppCapabilityResendSignature;
+    if (MAX_APDU_DATA_LENGTH > UINT8_MAX) {
+        capabilities |= AppCapabilityExtendedApdu;
+    }
+    return capabilities;
+}
+
 void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx, int rx) {
     if (!flags || !tx) {
         THROW(ApduReplySdkInvalidParameter);
@@ -48,12 +78,38 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx, int rx)
     }
 
     const int ret = apdu_handle_message(G_io_apdu_buffer, rx, &G_command);
+    if (ret == ApduReplySolanaUnexpectedOffset) {
+        // the upload in progress is kept, for the host to resume
+        *tx = set_result_upload_offset();
+        THROW(ret);
+    }
     if (ret != 0) {
         MEMCLEAR(G_command);
         THROW(ret);
     }
 
+    // a new sign command drops the signatures of the last approved message
+    switch (G_command.instruction) {
+        case InsDeprecatedSignMessage:
+        case InsSignMessage:
+        case InsSignOffchainMessage:
+        case InsSignBatchAdd:
+        case InsSignBatchReview:
+        case InsSignBatchSign:
+            signature_cache_clear();
+            break;
+        default:
+            break;
+    }
+
     if (G_command.state == ApduStatePayloadInProgress) {
+        if (G_command.instruction == InsDeprecatedSignMessage ||
+            G_command.instruction == InsSignMessage) {
+            handle_sign_message_chunk();
+        }
+        if (G_command.resumable) {
+            *tx = set_result_upload_offset();
+        }
         THROW(ApduReplySuccess);
     }
 
@@ -66,6 +122,13 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx, int rx)
             G_io_apdu_buffer[3] = MINOR_VERSION;
             G_io_apdu_buffer[4] = PATCH_VERSION;
             *tx = 5;
+            // Hosts of the deprecated instruction expect the original reply
+            if (G_command.instruction == InsGetAppConfiguration) {
+                G_io_apdu_buffer[5] = app_capabilities();
+                G_io_apdu_buffer[6] = MAX_APDU_DATA_LENGTH >> 8;
+                G_io_apdu_buffer[7] = MAX_APDU_DATA_LENGTH & 0xff;
+                *tx = 8;
+            }
             THROW(ApduReplySuccess);
 
         case InsDeprecatedGetPubkey:
@@ -73,6 +136,10 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx, int rx)
             handle_get_pubkey(flags, tx);
             break;
 
+        case InsGetPubkeys:
+            handle_get_pubkeys(tx);
+            break;
+
         case InsDeprecatedSignMessage:
         case InsSignMessage:
             handle_sign_message_parse_message(tx);
@@ -83,6 +150,22 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx, int rx)
             handle_sign_offchain_message(flags, tx);
             break;
 
+        case InsSignBatchAdd:
+            handle_sign_batch_add(tx);
+            break;
+
+        case InsSignBatchReview:
+            handle_sign_batch_review(flags);
+            break;
+
+        case InsSignBatchSign:
+            handle_sign_batch_sign(tx);
+            break;
+
+        case InsResendSignature:
+            handle_resend_signature(tx);
+            break;
+
         default:
             THROW(ApduReplyUnimplementedInstruction);
     }
@@ -95,7 +178,7 @@ void app_main(void) {
 
     // Stores the information about the current command. Some commands expect
     // multiple APDUs before they become complete and executed.
-    reset_getpubkey_globals();
+    command_scratch_reset();
     reset_main_globals();
 
     // DESIGN NOTE: the bootloader ignores the way APDU are fetched. The only
@@ -111,6 +194,22 @@ void app_main(void) {
                 rx = tx;
                 tx = 0;  // ensure no race in catch_other if io_exchange throws
                          // an error
+                const bool sign_upload = G_command.instruction == InsDeprecatedSignMessage ||
+                                         G_command.instruction == InsSignMessage ||
+                                         G_command.instruction == InsSignOffchainMessage ||
+                                         G_command.instruction == InsSignBatchAdd ||
+                                         G_command.instruction == InsSignBatchSign;
+                if (sign_upload && G_command.state == ApduStatePayloadInProgress &&
+                    !signer_key_is_derived(G_command.derivation_paths[0],
+                                           G_command.derivation_path_lengths[0])) {
+                    // The first chunk of a sign command carries the signer's
+                    // derivation path. Answer it right away, and derive the
+                    // key while the host sends the next chunk
+                    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, rx);
+                    rx = 0;
+                    signer_key_prefetch(G_command.derivation_paths[0],
+                                        G_command.derivation_path_lengths[0]);
+                }
                 rx = io_exchange(CHANNEL_APDU | flags, rx);
                 flags = 0;
 
@@ -149,6 +248,7 @@ void app_main(void) {
                 }
                 if (e != 0x9000) {
                     flags &= ~IO_ASYNCH_REPLY;
+                    signer_key_clear();
                 }
                 // Unexpected exception => report
                 G_io_apdu_buffer[tx] = sw >> 8;
@@ -199,6 +299,7 @@ unsigned char io_event(unsigned char channel) {
             break;
 
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            signature_cache_tick();
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {
 #if !defined(TARGET_NANOX) && !defined(TARGET_NANOS2)
                 if (UX_ALLOWED) {
@@ -250,6 +351,10 @@ unsigned short io_exchange_al(unsigned char channel, unsigned short tx_len) {
 }
 
 void app_exit(void) {
+    pubkey_cache_clear();
+    signer_key_clear();
+    sign_batch_clear();
+    signature_cache_clear();
     BEGIN_TRY_L(exit) {
         TRY_L(exit) {
             os_sched_exit(-1);
@@ -271,6 +376,7 @@ void nv_app_state_init() {
 #endif
         storage.settings.display_mode = DisplayModeUser;
         storage.initialized = 0x01;
+        MEMCLEAR(storage.pubkey_cache);
         nvm_write((void *) &N_storage, (void *) &storage, sizeof(internalStorage_t));
     }
 }
@@ -387,6 +493,12 @@ __attribute__((section(".boot"))) int main(int arg0) {
     // ensure exception will work as planned
     os_boot();
 
+    // RAM is not cleared when called as a library, do not trust what is left
+    pubkey_cache_clear();
+    signer_key_clear();
+    sign_batch_clear();
+    signature_cache_clear();
+
     if (arg0 == 0) {
         // called from dashboard as standalone app
         coin_main();
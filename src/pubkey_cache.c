@@ -0,0 +1,135 @@
+#include "pubkey_cache.h"
+#include "utils.h"
+
+PubkeyCache G_pubkey_cache;
+
+#define NV_CACHE_ROOT_LENGTH 2
+#define HARDENED_BIT         0x80000000
+
+// 44'/540', its public key is the seed fingerprint
+static const uint32_t NV_CACHE_ROOT[NV_CACHE_ROOT_LENGTH] = {HARDENED_BIT | 44,
+                                                             HARDENED_BIT | 540};
+
+static bool entry_matches(const PubkeyCacheEntry *entry,
+                          const uint32_t *derivation_path,
+                          size_t derivation_path_length) {
+    return entry->derivation_path_length == derivation_path_length &&
+           memcmp(entry->derivation_path,
+                  derivation_path,
+                  derivation_path_length * sizeof(uint32_t)) == 0;
+}
+
+// Moves entry `index` to the front, shifting the more recent ones back
+static PubkeyCacheEntry *promote_entry(size_t index) {
+    PubkeyCacheEntry *entries = G_pubkey_cache.entries;
+    if (index > 0) {
+        PubkeyCacheEntry entry = entries[index];
+        memmove(&entries[1], &entries[0], index * sizeof(PubkeyCacheEntry));
+        entries[0] = entry;
+        MEMCLEAR(entry);
+    }
+    return &entries[0];
+}
+
+// Returns the NVRAM entry of the account of `derivation_path`, or NULL when
+// that path is not kept in NVRAM. NVRAM is left alone when started from
+// Exchange, which does not allow the library app to write to flash
+static const PubkeyCacheEntry *nv_cache_slot(const uint32_t *derivation_path,
+                                             size_t derivation_path_length) {
+    if (G_called_from_swap) {
+        return NULL;
+    }
+    if (derivation_path_length <= NV_CACHE_ROOT_LENGTH ||
+        derivation_path_length > MAX_BIP32_PATH_LENGTH ||
+        memcmp(derivation_path, NV_CACHE_ROOT, sizeof(NV_CACHE_ROOT)) != 0) {
+        return NULL;
+    }
+    const uint32_t account = derivation_path[NV_CACHE_ROOT_LENGTH];
+    if ((account & HARDENED_BIT) == 0 || (account & ~HARDENED_BIT) >= NV_PUBKEY_CACHE_ACCOUNTS) {
+        return NULL;
+    }
+    return (const PubkeyCacheEntry *) &N_storage.pubkey_cache.entries[account & ~HARDENED_BIT];
+}
+
+// Checks, once per session, that the NVRAM entries were derived from the
+// current seed. They are erased if it has changed since
+static void nv_cache_check_seed(void) {
+    if (G_pubkey_cache.nv_state == NvPubkeyCacheUsable) {
+        return;
+    }
+    uint8_t fingerprint[PUBKEY_LENGTH];
+    get_public_key_uncached(fingerprint, NV_CACHE_ROOT, NV_CACHE_ROOT_LENGTH);
+    const void *saved_fingerprint = (const void *) N_storage.pubkey_cache.seed_fingerprint;
+    if (memcmp(fingerprint, saved_fingerprint, PUBKEY_LENGTH) != 0) {
+        // Erase the entries one at a time to keep the stack small, and only
+        // then save the new fingerprint so an interrupted erase is resumed
+        PubkeyCacheEntry empty_entry;
+        explicit_bzero(&empty_entry, sizeof(empty_entry));
+        for (size_t i = 0; i < NV_PUBKEY_CACHE_ACCOUNTS; i++) {
+            nvm_write((void *) &N_storage.pubkey_cache.entries[i],
+                      &empty_entry,
+                      sizeof(empty_entry));
+        }
+        nvm_write((void *) N_storage.pubkey_cache.seed_fingerprint, fingerprint, PUBKEY_LENGTH);
+    }
+    G_pubkey_cache.nv_state = NvPubkeyCacheUsable;
+}
+
+bool pubkey_cache_lookup(const uint32_t *derivation_path,
+                         size_t derivation_path_length,
+                         uint8_t public_key[PUBKEY_LENGTH]) {
+    if (derivation_path_length == 0 || derivation_path_length > MAX_BIP32_PATH_LENGTH) {
+        return false;
+    }
+    for (size_t i = 0; i < PUBKEY_CACHE_ENTRIES; i++) {
+        if (entry_matches(&G_pubkey_cache.entries[i], derivation_path, derivation_path_length)) {
+            memcpy(public_key, promote_entry(i)->public_key, PUBKEY_LENGTH);
+            return true;
+        }
+    }
+
+    const PubkeyCacheEntry *nv_entry = nv_cache_slot(derivation_path, derivation_path_length);
+    if (nv_entry == NULL) {
+        return false;
+    }
+    nv_cache_check_seed();
+    if (!entry_matches(nv_entry, derivation_path, derivation_path_length)) {
+        return false;
+    }
+    memcpy(public_key, nv_entry->public_key, PUBKEY_LENGTH);
+    pubkey_cache_insert(derivation_path, derivation_path_length, public_key);
+    return true;
+}
+
+void pubkey_cache_insert(const uint32_t *derivation_path,
+                         size_t derivation_path_length,
+                         const uint8_t public_key[PUBKEY_LENGTH]) {
+    if (derivation_path_length == 0 || derivation_path_length > MAX_BIP32_PATH_LENGTH) {
+        return;
+    }
+    // Reuse the entry of the same path if there is one, the oldest otherwise
+    size_t index = PUBKEY_CACHE_ENTRIES - 1;
+    for (size_t i = 0; i < PUBKEY_CACHE_ENTRIES; i++) {
+        if (entry_matches(&G_pubkey_cache.entries[i], derivation_path, derivation_path_length)) {
+            index = i;
+            break;
+        }
+    }
+    PubkeyCacheEntry *entry = promote_entry(index);
+    explicit_bzero(entry, sizeof(PubkeyCacheEntry));
+    memcpy(entry->derivation_path, derivation_path, derivation_path_length * sizeof(uint32_t));
+    entry->derivation_path_length = derivation_path_length;
+    memcpy(entry->public_key, public_key, PUBKEY_LENGTH);
+
+    // Fill the account NVRAM entry on first use only, to spare the flash.
+    // Keys derived before the seed was checked are not saved
+    const PubkeyCacheEntry *nv_entry = nv_cache_slot(derivation_path, derivation_path_length);
+    if (nv_entry != NULL && nv_entry->derivation_path_length == 0 &&
+        G_pubkey_cache.nv_state == NvPubkeyCacheUsable) {
+        nvm_write((void *) nv_entry, entry, sizeof(PubkeyCacheEntry));
+    }
+}
+
+void pubkey_cache_clear(void) {
+    explicit_bzero(&G_pubkey_cache, sizeof(G_pubkey_cache));
+}
@@ -0,0 +1,41 @@
+#include "os.h"
+#include "globals.h"
+
+#ifndef _PUBKEY_CACHE_H_
+#define _PUBKEY_CACHE_H_
+
+#define PUBKEY_CACHE_ENTRIES 4
+
+enum NvPubkeyCacheState {
+    // The seed fingerprint has not been checked yet during this session
+    NvPubkeyCacheUnchecked = 0,
+    NvPubkeyCacheUsable,
+};
+
+// Public keys derived during this app session, most recently used first.
+// The first accounts are also looked up in, and saved to, N_storage, except
+// when started from Exchange
+typedef struct PubkeyCache {
+    PubkeyCacheEntry entries[PUBKEY_CACHE_ENTRIES];
+    uint8_t nv_state;
+} PubkeyCache;
+
+extern PubkeyCache G_pubkey_cache;
+
+// Copies the cached public key of `derivation_path` into `public_key` and
+// marks it as most recently used. Returns false when the path is not cached
+bool pubkey_cache_lookup(const uint32_t *derivation_path,
+                         size_t derivation_path_length,
+                         uint8_t public_key[PUBKEY_LENGTH]);
+
+// Caches `public_key` for `derivation_path`, evicting the least recently used
+// entry if the cache is full
+void pubkey_cache_insert(const uint32_t *derivation_path,
+                         size_t derivation_path_length,
+                         const uint8_t public_key[PUBKEY_LENGTH]);
+
+// Clears the RAM cache. The NVRAM entries are kept, they are checked against
+// the seed again on next use
+void pubkey_cache_clear(void);
+
+#endif
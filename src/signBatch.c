@@ -0,0 +1,311 @@
+#include "os.h"
+#include "ux.h"
+#include "cx.h"
+#include "menu.h"
+#include "utils.h"
+#include "sol/parser.h"
+#include "sol/printer.h"
+#include "sol/print_config.h"
+#include "sol/message.h"
+#include "sol/transaction_summary.h"
+#include "globals.h"
+#include "apdu.h"
+#include "command_scratch.h"
+#include "signer_key.h"
+#include "signBatch.h"
+#include "signature_cache.h"
+
+SignBatch G_sign_batch;
+
+#define batch_view (G_command_scratch.view.sign_batch)
+
+void sign_batch_clear(void) {
+    explicit_bzero(&G_sign_batch, sizeof(G_sign_batch));
+    signer_key_clear();
+}
+
+// The summaries collected so far are lost once another command claims the
+// scratch buffer, and the batch with them
+static void sign_batch_check_scratch(void) {
+    if (G_sign_batch.scratch_generation != G_command_scratch.generation) {
+        sign_batch_clear();
+        THROW(ApduReplySdkInvalidState);
+    }
+}
+
+static int sign_batch_push_string(const char *string, uint16_t *offset) {
+    const size_t length = strlen(string) + 1;
+    if (length > sizeof(batch_view.arena) - batch_view.arena_used) {
+        return 1;
+    }
+    memcpy(batch_view.arena + batch_view.arena_used, string, length);
+    *offset = batch_view.arena_used;
+    batch_view.arena_used += length;
+    return 0;
+}
+
+static int sign_batch_push_step(uint16_t title_offset, uint16_t text_offset) {
+    if (batch_view.step_count == MAX_SIGN_BATCH_STEPS) {
+        return 1;
+    }
+    SignBatchStep *step = &batch_view.steps[batch_view.step_count++];
+    step->title_offset = title_offset;
+    step->text_offset = text_offset;
+    return 0;
+}
+
+// Copies the finalized transaction summary into the batch, after a step
+// opening the message. Pubkeys are rendered as the settings ask, like a
+// single transaction review
+static int sign_batch_push_summary(size_t num_summary_steps) {
+    if (sign_batch_push_step(SIGN_BATCH_MESSAGE_STEP, G_sign_batch.message_count) != 0) {
+        return 1;
+    }
+    enum DisplayFlags flags = DisplayFlagNone;
+    if (N_storage.settings.pubkey_display == PubkeyDisplayLong) {
+        flags |= DisplayFlagLongPubkeys;
+    }
+    for (size_t i = 0; i < num_summary_steps; i++) {
+        uint16_t title_offset;
+        uint16_t text_offset;
+        if (transaction_summary_display_item(i, flags) != 0 ||
+            sign_batch_push_string(G_transaction_summary_title, &title_offset) != 0 ||
+            sign_batch_push_string(G_transaction_summary_text, &text_offset) != 0 ||
+            sign_batch_push_step(title_offset, text_offset) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static bool header_has_signer(const MessageHeader *header, const uint8_t *signer_pubkey) {
+    for (size_t i = 0; i < header->pubkeys_header.num_required_signatures; ++i) {
+        if (memcmp(&header->pubkeys[i], signer_pubkey, PUBKEY_SIZE) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool sign_batch_has_derivation_path(void) {
+    return G_sign_batch.derivation_path_length == G_command.derivation_path_lengths[0] &&
+           memcmp(G_sign_batch.derivation_path,
+                  G_command.derivation_paths[0],
+                  G_command.derivation_path_lengths[0] * sizeof(uint32_t)) == 0;
+}
+
+void handle_sign_batch_add(volatile unsigned int *tx) {
+    if (!tx || G_command.instruction != InsSignBatchAdd ||
+        G_command.state != ApduStatePayloadComplete) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+    // The Exchange application signs a single transaction at a time
+    if (G_command.non_confirm || G_called_from_swap) {
+        THROW(ApduReplySdkNotSupported);
+    }
+
+    if (G_sign_batch.state != SignBatchCollecting) {
+        sign_batch_clear();
+        command_scratch_claim(sizeof(SignBatchScratch));
+        G_sign_batch.scratch_generation = G_command_scratch.generation;
+        G_sign_batch.state = SignBatchCollecting;
+        memcpy(G_sign_batch.derivation_path,
+               G_command.derivation_paths[0],
+               sizeof(G_sign_batch.derivation_path));
+        G_sign_batch.derivation_path_length = G_command.derivation_path_lengths[0];
+    } else {
+        sign_batch_check_scratch();
+    }
+    if (!sign_batch_has_derivation_path()) {
+        // All the messages of a batch have the same signer
+        THROW(ApduReplySolanaInvalidMessage);
+    }
+    if (G_sign_batch.message_count == MAX_SIGN_BATCH_MESSAGES) {
+        THROW(ApduReplySdkNotEnoughSpace);
+    }
+
+    PrintConfig print_config;
+    print_config.expert_mode = (N_storage.settings.display_mode == DisplayModeExpert);
+    print_config.signer_pubkey = NULL;
+    print_config.summary = NULL;
+    MessageHeader *header = &print_config.header;
+
+    const MessageHeader *stream_header = message_stream_header();
+    if (stream_header == NULL) {
+        THROW(ApduReplySolanaInvalidMessage);
+    }
+    *header = *stream_header;
+
+    uint8_t signer_pubkey[PUBKEY_LENGTH];
+    get_public_key(signer_pubkey,
+                   G_command.derivation_paths[0],
+                   G_command.derivation_path_lengths[0]);
+    if (!header_has_signer(header, signer_pubkey)) {
+        THROW(ApduReplySolanaInvalidMessageHeader);
+    }
+    print_config.signer_pubkey = (const Pubkey *) signer_pubkey;
+
+    // Messages that could only be blind signed have nothing to show in a batch
+    transaction_summary_reset();
+    if (message_stream_print(G_command.message,
+                             G_command.message_length,
+                             batch_view.instruction_arena,
+                             sizeof(batch_view.instruction_arena),
+                             &print_config) != 0) {
+        THROW(ApduReplySdkNotSupported);
+    }
+    const Pubkey *fee_payer = &header->pubkeys[0];
+    if (print_config_show_authority(&print_config, fee_payer)) {
+        transaction_summary_set_fee_payer_pubkey(fee_payer);
+    }
+
+    SummaryItemKind_t summary_step_kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
+    size_t num_summary_steps = 0;
+    if (transaction_summary_finalize(summary_step_kinds, &num_summary_steps) != 0) {
+        THROW(ApduReplySolanaSummaryFinalizeFailed);
+    }
+
+    // A message that does not fit leaves the batch as it was
+    const size_t step_count = batch_view.step_count;
+    const size_t arena_used = batch_view.arena_used;
+    if (sign_batch_push_summary(num_summary_steps) != 0) {
+        batch_view.step_count = step_count;
+        batch_view.arena_used = arena_used;
+        THROW(ApduReplySdkNotEnoughSpace);
+    }
+
+    memcpy(&G_sign_batch.message_hashes[G_sign_batch.message_count],
+           &G_command.message_hash,
+           HASH_LENGTH);
+    G_sign_batch.message_count++;
+
+    *tx = 0;
+    THROW(ApduReplySuccess);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+static void sign_batch_display_step(size_t step_index) {
+    char *title = G_transaction_summary_title;
+    char *text = G_transaction_summary_text;
+
+    if (step_index >= batch_view.step_count) {
+        THROW(ApduReplySolanaSummaryUpdateFailed);
+    }
+
+    const SignBatchStep *step = &batch_view.steps[step_index];
+    if (step->title_offset == SIGN_BATCH_MESSAGE_STEP) {
+        // "Transaction", "<n> of <count>"
+        strcpy(title, "Transaction");
+        if (print_u64(step->text_offset + 1, text, TEXT_BUFFER_LENGTH) != 0) {
+            THROW(ApduReplySolanaSummaryUpdateFailed);
+        }
+        const size_t length = strlen(text);
+        memcpy(text + length, " of ", 4);
+        if (print_u64(G_sign_batch.message_count,
+                      text + length + 4,
+                      TEXT_BUFFER_LENGTH - length - 4) != 0) {
+            THROW(ApduReplySolanaSummaryUpdateFailed);
+        }
+        return;
+    }
+    // The arena holds copies of these buffers, so they fit back
+    strcpy(title, batch_view.arena + step->title_offset);
+    strcpy(text, batch_view.arena + step->text_offset);
+}
+
+static void sign_batch_approve(void) {
+    G_sign_batch.state = SignBatchApproved;
+    sendResponse(0, true, true);
+}
+
+static void sign_batch_reject(void) {
+    sign_batch_clear();
+    sendResponse(0, false, true);
+}
+
+UX_STEP_NOCB_INIT(ux_sign_batch_step,
+                  bnnn_paging,
+                  { sign_batch_display_step(G_ux.flow_stack[stack_slot].index); },
+                  {
+                      .title = G_transaction_summary_title,
+                      .text = G_transaction_summary_text,
+                  });
+UX_STEP_CB(ux_sign_batch_approve_step,
+           pb,
+           sign_batch_approve(),
+           {
+               &C_icon_validate_14,
+               "Approve",
+           });
+UX_STEP_CB(ux_sign_batch_reject_step,
+           pb,
+           sign_batch_reject(),
+           {
+               &C_icon_crossmark,
+               "Reject",
+           });
+
+#define flow_steps (G_command_scratch.view.sign_batch.flow_steps)
+
+void handle_sign_batch_review(volatile unsigned int *flags) {
+    if (!flags || G_command.instruction != InsSignBatchReview ||
+        G_command.state != ApduStatePayloadComplete) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+    if (G_called_from_swap) {
+        THROW(ApduReplySdkNotSupported);
+    }
+    if (G_sign_batch.state != SignBatchCollecting || G_sign_batch.message_count == 0) {
+        THROW(ApduReplySdkInvalidState);
+    }
+    sign_batch_check_scratch();
+
+    size_t num_flow_steps = 0;
+    for (size_t i = 0; i < batch_view.step_count; i++) {
+        flow_steps[num_flow_steps++] = &ux_sign_batch_step;
+    }
+    flow_steps[num_flow_steps++] = &ux_sign_batch_approve_step;
+    flow_steps[num_flow_steps++] = &ux_sign_batch_reject_step;
+    flow_steps[num_flow_steps++] = FLOW_END_STEP;
+
+    ux_flow_init(0, flow_steps, NULL);
+
+    *flags |= IO_ASYNCH_REPLY;
+}
+
+void handle_sign_batch_sign(volatile unsigned int *tx) {
+    if (!tx || G_command.instruction != InsSignBatchSign ||
+        G_command.state != ApduStatePayloadComplete) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+    if (G_called_from_swap) {
+        THROW(ApduReplySdkNotSupported);
+    }
+    if (G_sign_batch.state != SignBatchApproved) {
+        THROW(ApduReplySdkInvalidState);
+    }
+
+    const Hash *approved_hash = &G_sign_batch.message_hashes[G_sign_batch.signed_count];
+    if (!sign_batch_has_derivation_path() ||
+        memcmp(&G_command.message_hash, approved_hash, HASH_LENGTH) != 0) {
+        // Not what was approved, give up on the whole batch
+        sign_batch_clear();
+        THROW(ApduReplySolanaInvalidMessage);
+    }
+
+    signer_key_sign(G_sign_batch.derivation_path,
+                    G_sign_batch.derivation_path_length,
+                    G_command.message,
+                    G_command.message_length,
+                    G_io_apdu_buffer);
+    // Each message is its own command, its signer key goes with its answer
+    signer_key_clear();
+    signature_cache_store(&G_command.message_hash, G_io_apdu_buffer, SIGNATURE_LENGTH);
+    if (++G_sign_batch.signed_count == G_sign_batch.message_count) {
+        sign_batch_clear();
+    }
+
+    *tx = SIGNATURE_LENGTH;
+    THROW(ApduReplySuccess);
+}
@@ -0,0 +1,67 @@
+#include "os.h"
+#include "cx.h"
+#include "globals.h"
+#include "sol/parser.h"
+
+#ifndef _SIGN_BATCH_H_
+#define _SIGN_BATCH_H_
+
+#if defined(TARGET_NANOS)
+#define MAX_SIGN_BATCH_MESSAGES 3
+#define MAX_SIGN_BATCH_STEPS    18
+#define SIGN_BATCH_ARENA_SIZE   320
+#else
+#define MAX_SIGN_BATCH_MESSAGES 16
+#define MAX_SIGN_BATCH_STEPS    96
+#define SIGN_BATCH_ARENA_SIZE   1536
+#endif
+
+// Batch steps, then approve, reject and FLOW_END_STEP
+#define MAX_SIGN_BATCH_FLOW_STEPS (MAX_SIGN_BATCH_STEPS + 3)
+
+// Title offset of the step opening the summary of a message, its text offset
+// is the index of the message
+#define SIGN_BATCH_MESSAGE_STEP UINT16_MAX
+
+enum SignBatchState {
+    SignBatchIdle = 0,
+    SignBatchCollecting,
+    SignBatchApproved,
+};
+
+typedef struct SignBatchStep {
+    uint16_t title_offset;
+    uint16_t text_offset;
+} SignBatchStep;
+
+// Messages signed after a single review. They are uploaded a first time to
+// build the review, which only keeps their hash and rendered summary, then a
+// second time once approved to be signed. The rendered summaries live in the
+// sign batch view of G_command_scratch until the review is done
+typedef struct SignBatch {
+    uint8_t state;  // enum SignBatchState
+    uint8_t message_count;
+    uint8_t signed_count;
+    uint32_t derivation_path[MAX_BIP32_PATH_LENGTH];
+    uint32_t derivation_path_length;
+    // G_command_scratch generation of the claim holding the summaries
+    uint32_t scratch_generation;
+    Hash message_hashes[MAX_SIGN_BATCH_MESSAGES];
+} SignBatch;
+
+extern SignBatch G_sign_batch;
+
+// Decodes a message and adds it to the batch, starting a new batch unless one
+// is being collected
+void handle_sign_batch_add(volatile unsigned int *tx);
+
+// Shows the summary of all the messages of the batch for approval
+void handle_sign_batch_review(volatile unsigned int *flags);
+
+// Signs the next message of an approved batch, which must be the one added
+// at the same position
+void handle_sign_batch_sign(volatile unsigned int *tx);
+
+void sign_batch_clear(void);
+
+#endif
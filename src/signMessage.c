@@ -11,39 +11,25 @@
 #include "sol/transaction_summary.h"
 #include "globals.h"
 #include "apdu.h"
+#include "command_scratch.h"
+#include "signer_key.h"
+#include "signature_cache.h"
 
 #include "handle_swap_sign_transaction.h"
 
+// One signature per signer, in the order of their derivation paths
 static uint8_t set_result_sign_message() {
-    uint8_t signature[SIGNATURE_LENGTH];
-    cx_ecfp_private_key_t privateKey;
-    BEGIN_TRY {
-        TRY {
-            get_private_key_with_seed(&privateKey,
-                                      G_command.derivation_path,
-                                      G_command.derivation_path_length);
-            cx_eddsa_sign(&privateKey,
-                          CX_LAST,
-                          CX_SHA512,
-                          G_command.message,
-                          G_command.message_length,
-                          NULL,
-                          0,
-                          signature,
-                          SIGNATURE_LENGTH,
-                          NULL);
-            memcpy(G_io_apdu_buffer, signature, SIGNATURE_LENGTH);
-        }
-        CATCH_OTHER(e) {
-            MEMCLEAR(privateKey);
-            THROW(e);
-        }
-        FINALLY {
-            MEMCLEAR(privateKey);
-        }
+    uint8_t tx = 0;
+    for (size_t i = 0; i < G_command.num_derivation_paths; i++) {
+        signer_key_sign(G_command.derivation_paths[i],
+                        G_command.derivation_path_lengths[i],
+                        G_command.message,
+                        G_command.message_length,
+                        G_io_apdu_buffer + tx);
+        tx += SIGNATURE_LENGTH;
     }
-    END_TRY;
-    return SIGNATURE_LENGTH;
+    signature_cache_store(&G_command.message_hash, G_io_apdu_buffer, tx);
+    return tx;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -79,19 +65,11 @@ UX_STEP_NOCB_INIT(ux_summary_step,
                       .text = G_transaction_summary_text,
                   });
 
-#define MAX_FLOW_STEPS                                     \
-    (MAX_TRANSACTION_SUMMARY_ITEMS + 1 /* approve */       \
-     + 1                               /* reject */        \
-     + 1                               /* FLOW_END_STEP */ \
-    )
-ux_flow_step_t const *flow_steps[MAX_FLOW_STEPS];
+#define flow_steps (G_command_scratch.view.sign_message.flow_steps)
 
-static int scan_header_for_signer(const uint32_t *derivation_path,
-                                  uint32_t derivation_path_length,
+static int scan_header_for_signer(const uint8_t *signer_pubkey,
                                   size_t *signer_index,
                                   const MessageHeader *header) {
-    uint8_t signer_pubkey[PUBKEY_SIZE];
-    get_public_key(signer_pubkey, derivation_path, derivation_path_length);
     for (size_t i = 0; i < header->pubkeys_header.num_required_signatures; ++i) {
         const Pubkey *current_pubkey = &(header->pubkeys[i]);
         if (memcmp(current_pubkey, signer_pubkey, PUBKEY_SIZE) == 0) {
@@ -102,6 +80,21 @@ static int scan_header_for_signer(const uint32_t *derivation_path,
     return -1;
 }
 
+void handle_sign_message_chunk(void) {
+    if ((G_command.instruction != InsDeprecatedSignMessage &&
+         G_command.instruction != InsSignMessage) ||
+        G_command.state != ApduStatePayloadInProgress) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+    // The message stream is fed by apdu_handle_message(). If what has been
+    // received so far can only be blind signed, don't wait for the rest
+    if (message_stream_state() == MessageStreamUnrecognized &&
+        N_storage.settings.allow_blind_sign != BlindSignEnabled) {
+        MEMCLEAR(G_command);
+        THROW(ApduReplySdkNotSupported);
+    }
+}
+
 void handle_sign_message_parse_message(volatile unsigned int *tx) {
     if (!tx ||
         (G_command.instruction != InsDeprecatedSignMessage &&
@@ -109,27 +102,46 @@ void handle_sign_message_parse_message(volatile unsigned int *tx) {
         G_command.state != ApduStatePayloadComplete) {
         THROW(ApduReplySdkInvalidParameter);
     }
-    // Handle the transaction message signing
-    Parser parser = {G_command.message, G_command.message_length};
+    // Handle the transaction message signing. The message has already been
+    // decoded chunk by chunk as it was received
     PrintConfig print_config;
     print_config.expert_mode = (N_storage.settings.display_mode == DisplayModeExpert);
     print_config.signer_pubkey = NULL;
+    print_config.summary = NULL;
     MessageHeader *header = &print_config.header;
     size_t signer_index;
 
-    if (parse_message_header(&parser, header) != 0) {
+    const MessageHeader *stream_header = message_stream_header();
+    if (stream_header == NULL) {
         // This is not a valid Solana message
         THROW(ApduReplySolanaInvalidMessage);
     }
+    *header = *stream_header;
+
+    // The Exchange app expects a single signature
+    if (G_called_from_swap && G_command.num_derivation_paths != 1) {
+        THROW(ApduReplySdkNotSupported);
+    }
 
-    // Ensure the requested signer is present in the header
-    if (scan_header_for_signer(G_command.derivation_path,
-                               G_command.derivation_path_length,
-                               &signer_index,
-                               header) != 0) {
+    // Ensure every requested signer is present in the header. The key of the
+    // first one is derived once, the same key signs the message when it is
+    // approved. Its pubkey is the one hidden from the summary
+    const Pubkey *first_signer_pubkey = signer_key_public_key(G_command.derivation_paths[0],
+                                                              G_command.derivation_path_lengths[0]);
+    if (scan_header_for_signer(first_signer_pubkey->data, &signer_index, header) != 0) {
         THROW(ApduReplySolanaInvalidMessageHeader);
     }
     print_config.signer_pubkey = &header->pubkeys[signer_index];
+    for (size_t i = 1; i < G_command.num_derivation_paths; i++) {
+        uint8_t signer_pubkey[PUBKEY_LENGTH];
+        size_t other_signer_index;
+        get_public_key(signer_pubkey,
+                       G_command.derivation_paths[i],
+                       G_command.derivation_path_lengths[i]);
+        if (scan_header_for_signer(signer_pubkey, &other_signer_index, header) != 0) {
+            THROW(ApduReplySolanaInvalidMessageHeader);
+        }
+    }
 
     if (G_command.non_confirm) {
         // Uncomment this to allow unattended signing.
@@ -140,20 +152,20 @@ void handle_sign_message_parse_message(volatile unsigned int *tx) {
     }
 
     // Set the transaction summary
+    command_scratch_claim(sizeof(SignMessageScratch));
     transaction_summary_reset();
-    if (process_message_body(parser.buffer, parser.buffer_length, &print_config) != 0) {
+    if (message_stream_print(G_command.message,
+                             G_command.message_length,
+                             G_command_scratch.view.sign_message.instruction_arena,
+                             sizeof(G_command_scratch.view.sign_message.instruction_arena),
+                             &print_config) != 0) {
         // Message not processed, throw if blind signing is not enabled
         if (N_storage.settings.allow_blind_sign == BlindSignEnabled) {
             SummaryItem *item = transaction_summary_primary_item();
-            summary_item_set_string(item, "Unrecognized", "format");
-
-            cx_hash_sha256(G_command.message,
-                           G_command.message_length,
-                           (uint8_t *) &G_command.message_hash,
-                           HASH_LENGTH);
+            summary_item_set_string(item, SummaryTitleUnrecognized, "format");
 
             item = transaction_summary_general_item();
-            summary_item_set_hash(item, "Message Hash", &G_command.message_hash);
+            summary_item_set_hash(item, SummaryTitleMessageHash, &G_command.message_hash);
         } else {
             THROW(ApduReplySdkNotSupported);
         }
@@ -175,15 +187,19 @@ static bool check_swap_validity(const SummaryItemKind_t kinds[MAX_TRANSACTION_SU
         return false;
     }
     for (size_t i = 0; i < num_summary_steps; ++i) {
-        transaction_summary_display_item(i, DisplayFlagNone | DisplayFlagLongPubkeys);
+        // Pubkeys are rendered in long form
+        if (transaction_summary_display_item(i, DisplayFlagLongPubkeys) != 0) {
+            PRINTF("Step %u not rendered\n", i);
+            return false;
+        }
+        const char *title = G_transaction_summary_title;
+        const char *text = G_transaction_summary_text;
         switch (kinds[i]) {
             case SummaryItemAmount:
-                amount_ok =
-                    check_swap_amount(G_transaction_summary_title, G_transaction_summary_text);
+                amount_ok = check_swap_amount(title, text);
                 break;
             case SummaryItemPubkey:
-                recipient_ok =
-                    check_swap_recipient(G_transaction_summary_title, G_transaction_summary_text);
+                recipient_ok = check_swap_recipient(title, text);
                 break;
             default:
                 PRINTF("Refused kind '%u'\n", kinds[i]);
@@ -221,7 +237,6 @@ void handle_sign_message_ui(volatile unsigned int *flags) {
                 THROW(ApduReplySolanaSummaryFinalizeFailed);
             }
         } else {
-            MEMCLEAR(flow_steps);
             size_t num_flow_steps = 0;
 
             for (size_t i = 0; i < num_summary_steps; i++) {
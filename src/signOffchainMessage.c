@@ -11,9 +11,9 @@
 #include "sol/transaction_summary.h"
 #include "globals.h"
 #include "apdu.h"
-
-// Store locally the derived public key content
-static Pubkey G_publicKey;
+#include "command_scratch.h"
+#include "signer_key.h"
+#include "signature_cache.h"
 
 /**
  * Checks if data is in UTF-8 format.
@@ -80,34 +80,12 @@ static bool is_data_ascii(const uint8_t *data, size_t length) {
 }
 
 static uint8_t set_result_sign_message() {
-    uint8_t signature[SIGNATURE_LENGTH];
-    cx_ecfp_private_key_t privateKey;
-    BEGIN_TRY {
-        TRY {
-            get_private_key_with_seed(&privateKey,
-                                      G_command.derivation_path,
-                                      G_command.derivation_path_length);
-            cx_eddsa_sign(&privateKey,
-                          CX_LAST,
-                          CX_SHA512,
-                          G_command.message,
-                          G_command.message_length,
-                          NULL,
-                          0,
-                          signature,
-                          SIGNATURE_LENGTH,
-                          NULL);
-            memcpy(G_io_apdu_buffer, signature, SIGNATURE_LENGTH);
-        }
-        CATCH_OTHER(e) {
-            MEMCLEAR(privateKey);
-            THROW(e);
-        }
-        FINALLY {
-            MEMCLEAR(privateKey);
-        }
-    }
-    END_TRY;
+    signer_key_sign(G_command.derivation_paths[0],
+                    G_command.derivation_path_lengths[0],
+                    G_command.message,
+                    G_command.message_length,
+                    G_io_apdu_buffer);
+    signature_cache_store(&G_command.message_hash, G_io_apdu_buffer, SIGNATURE_LENGTH);
     return SIGNATURE_LENGTH;
 }
 
@@ -166,7 +144,7 @@ else if utf8:
 if ascii:
 - message text
 */
-static ux_flow_step_t const *flow_steps[8];
+#define flow_steps (G_command_scratch.view.sign_offchain_message.flow_steps)
 
 void handle_sign_offchain_message(volatile unsigned int *flags, volatile unsigned int *tx) {
     if (!tx || G_command.instruction != InsSignOffchainMessage ||
@@ -182,6 +160,8 @@ void handle_sign_offchain_message(volatile unsigned int *flags, volatile unsigne
         THROW(ApduReplySdkNotSupported);
     }
 
+    command_scratch_claim(sizeof(SignOffchainMessageScratch));
+
     // parse header
     Parser parser = {G_command.message, G_command.message_length};
     OffchainMessageHeader header;
@@ -205,31 +185,32 @@ void handle_sign_offchain_message(volatile unsigned int *flags, volatile unsigne
         THROW(ApduReplySdkNotSupported);
     }
 
-    // compute message hash if needed
-    if (!is_ascii || N_storage.settings.display_mode == DisplayModeExpert) {
-        cx_hash_sha256(G_command.message,
-                       G_command.message_length,
-                       (uint8_t *) &G_command.message_hash,
-                       HASH_LENGTH);
-    }
-
     // fill out UX steps
     transaction_summary_reset();
     SummaryItem *item = transaction_summary_primary_item();
-    summary_item_set_string(item, "Sign", "Off-Chain Message");
+    summary_item_set_string(item, SummaryTitleSign, "Off-Chain Message");
 
     if (N_storage.settings.display_mode == DisplayModeExpert) {
-        summary_item_set_u64(transaction_summary_general_item(), "Version", header.version);
-        summary_item_set_u64(transaction_summary_general_item(), "Format", header.format);
-        summary_item_set_u64(transaction_summary_general_item(), "Size", header.length);
-        summary_item_set_hash(transaction_summary_general_item(), "Hash", &G_command.message_hash);
-
-        get_public_key(G_publicKey.data,
-                       G_command.derivation_path,
-                       G_command.derivation_path_length);
-        summary_item_set_pubkey(transaction_summary_general_item(), "Signer", &G_publicKey);
+        summary_item_set_u64(transaction_summary_general_item(),
+                             SummaryTitleVersion,
+                             header.version);
+        summary_item_set_u64(transaction_summary_general_item(),
+                             SummaryTitleFormat,
+                             header.format);
+        summary_item_set_u64(transaction_summary_general_item(), SummaryTitleSize, header.length);
+        summary_item_set_hash(transaction_summary_general_item(),
+                              SummaryTitleHash,
+                              &G_command.message_hash);
+
+        const Pubkey *signer_pubkey = signer_key_public_key(G_command.derivation_paths[0],
+                                                            G_command.derivation_path_lengths[0]);
+        summary_item_set_pubkey(transaction_summary_general_item(),
+                                SummaryTitleSigner,
+                                signer_pubkey);
     } else if (!is_ascii) {
-        summary_item_set_hash(transaction_summary_general_item(), "Hash", &G_command.message_hash);
+        summary_item_set_hash(transaction_summary_general_item(),
+                              SummaryTitleHash,
+                              &G_command.message_hash);
     }
 
     enum SummaryItemKind summary_step_kinds[MAX_TRANSACTION_SUMMARY_ITEMS];
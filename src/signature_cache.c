@@ -0,0 +1,50 @@
+#include "signature_cache.h"
+#include "apdu.h"
+#include "utils.h"
+
+SignatureCache G_signature_cache;
+
+void signature_cache_store(const Hash *message_hash,
+                           const uint8_t *signatures,
+                           size_t signatures_length) {
+    signature_cache_clear();
+    if (signatures_length == 0 || signatures_length > sizeof(G_signature_cache.signatures)) {
+        return;
+    }
+    memcpy(&G_signature_cache.message_hash, message_hash, HASH_LENGTH);
+    memcpy(G_signature_cache.signatures, signatures, signatures_length);
+    G_signature_cache.signatures_length = signatures_length;
+    G_signature_cache.ticks_left = SIGNATURE_CACHE_TICKS;
+}
+
+void signature_cache_tick(void) {
+    if (G_signature_cache.signatures_length == 0) {
+        return;
+    }
+    if (--G_signature_cache.ticks_left == 0) {
+        signature_cache_clear();
+    }
+}
+
+void handle_resend_signature(volatile unsigned int *tx) {
+    if (!tx || G_command.instruction != InsResendSignature ||
+        G_command.state != ApduStatePayloadComplete) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+    if (G_command.message_length != HASH_LENGTH) {
+        THROW(ApduReplySolanaInvalidMessageSize);
+    }
+
+    const size_t length = G_signature_cache.signatures_length;
+    if (length == 0 ||
+        memcmp(&G_signature_cache.message_hash, G_command.message, HASH_LENGTH) != 0) {
+        THROW(ApduReplySdkInvalidState);
+    }
+    memcpy(G_io_apdu_buffer, G_signature_cache.signatures, length);
+    *tx = length;
+    THROW(ApduReplySuccess);
+}
+
+void signature_cache_clear(void) {
+    explicit_bzero(&G_signature_cache, sizeof(G_signature_cache));
+}
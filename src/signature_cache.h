@@ -0,0 +1,37 @@
+#include "os.h"
+#include "globals.h"
+#include "sol/parser.h"
+
+#ifndef _SIGNATURE_CACHE_H_
+#define _SIGNATURE_CACHE_H_
+
+// How long signatures are kept, in ticker events of 100ms
+#define SIGNATURE_CACHE_TICKS 300
+
+// Signatures of the last approved message, kept for a short while so that a
+// host that lost the reply can get them again without another review
+typedef struct SignatureCache {
+    Hash message_hash;
+    uint8_t signatures[MAX_DERIVATION_PATHS * SIGNATURE_LENGTH];
+    // 0 when no signature is held
+    uint8_t signatures_length;
+    uint16_t ticks_left;
+} SignatureCache;
+
+extern SignatureCache G_signature_cache;
+
+// Keeps `signatures` of the message hashed to `message_hash`, replacing what
+// was held
+void signature_cache_store(const Hash *message_hash,
+                           const uint8_t *signatures,
+                           size_t signatures_length);
+
+// Counts down the time the signatures are kept, called on every ticker event
+void signature_cache_tick(void);
+
+// Returns the signatures of the message whose hash is the command data
+void handle_resend_signature(volatile unsigned int *tx);
+
+void signature_cache_clear(void);
+
+#endif
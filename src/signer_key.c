@@ -0,0 +1,89 @@
+#include "signer_key.h"
+#include "pubkey_cache.h"
+#include "utils.h"
+
+SignerKey G_signer_key;
+
+bool signer_key_is_derived(const uint32_t *derivation_path, size_t derivation_path_length) {
+    return derivation_path_length != 0 &&
+           G_signer_key.derivation_path_length == derivation_path_length &&
+           memcmp(G_signer_key.derivation_path,
+                  derivation_path,
+                  derivation_path_length * sizeof(uint32_t)) == 0;
+}
+
+static SignerKey *signer_key_get(const uint32_t *derivation_path, size_t derivation_path_length) {
+    if (derivation_path_length == 0 || derivation_path_length > MAX_BIP32_PATH_LENGTH) {
+        THROW(ApduReplySdkInvalidParameter);
+    }
+    if (signer_key_is_derived(derivation_path, derivation_path_length)) {
+        return &G_signer_key;
+    }
+
+    signer_key_clear();
+    BEGIN_TRY {
+        TRY {
+            get_private_key_with_seed(&G_signer_key.private_key,
+                                      derivation_path,
+                                      derivation_path_length);
+            get_public_key_from_private_key(G_signer_key.public_key.data,
+                                            &G_signer_key.private_key);
+        }
+        CATCH_OTHER(e) {
+            signer_key_clear();
+            THROW(e);
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+    memcpy(G_signer_key.derivation_path,
+           derivation_path,
+           derivation_path_length * sizeof(uint32_t));
+    G_signer_key.derivation_path_length = derivation_path_length;
+
+    pubkey_cache_insert(derivation_path, derivation_path_length, G_signer_key.public_key.data);
+    return &G_signer_key;
+}
+
+const Pubkey *signer_key_public_key(const uint32_t *derivation_path,
+                                    size_t derivation_path_length) {
+    return &signer_key_get(derivation_path, derivation_path_length)->public_key;
+}
+
+void signer_key_sign(const uint32_t *derivation_path,
+                     size_t derivation_path_length,
+                     const uint8_t *message,
+                     size_t message_length,
+                     uint8_t signature[SIGNATURE_LENGTH]) {
+    SignerKey *key = signer_key_get(derivation_path, derivation_path_length);
+    cx_eddsa_sign(&key->private_key,
+                  CX_LAST,
+                  CX_SHA512,
+                  message,
+                  message_length,
+                  NULL,
+                  0,
+                  signature,
+                  SIGNATURE_LENGTH,
+                  NULL);
+}
+
+void signer_key_prefetch(const uint32_t *derivation_path, size_t derivation_path_length) {
+    BEGIN_TRY {
+        TRY {
+            signer_key_get(derivation_path, derivation_path_length);
+        }
+        CATCH_OTHER(e) {
+            // left for the command to report when it needs the key
+            UNUSED(e);
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+}
+
+void signer_key_clear(void) {
+    explicit_bzero(&G_signer_key, sizeof(G_signer_key));
+}
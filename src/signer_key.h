@@ -0,0 +1,43 @@
+#include "os.h"
+#include "cx.h"
+#include "globals.h"
+#include "sol/parser.h"
+
+#ifndef _SIGNER_KEY_H_
+#define _SIGNER_KEY_H_
+
+// Key pair of the signer of the running command, derived once and kept until
+// the command is answered
+typedef struct SignerKey {
+    cx_ecfp_private_key_t private_key;
+    Pubkey public_key;
+    uint32_t derivation_path[MAX_BIP32_PATH_LENGTH];
+    // 0 when no key is held
+    uint8_t derivation_path_length;
+} SignerKey;
+
+extern SignerKey G_signer_key;
+
+// Returns the public key of `derivation_path`, deriving the key pair unless it
+// is already held
+const Pubkey *signer_key_public_key(const uint32_t *derivation_path,
+                                    size_t derivation_path_length);
+
+// Signs `message` with the key of `derivation_path`, deriving the key pair
+// unless it is already held
+void signer_key_sign(const uint32_t *derivation_path,
+                     size_t derivation_path_length,
+                     const uint8_t *message,
+                     size_t message_length,
+                     uint8_t signature[SIGNATURE_LENGTH]);
+
+// Whether the key pair of `derivation_path` is already held
+bool signer_key_is_derived(const uint32_t *derivation_path, size_t derivation_path_length);
+
+// Derives the key pair of `derivation_path` ahead of its use. Errors are not
+// reported, they are raised again when the key is needed
+void signer_key_prefetch(const uint32_t *derivation_path, size_t derivation_path_length);
+
+void signer_key_clear(void);
+
+#endif
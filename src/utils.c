@@ -4,15 +4,27 @@
 #include <stdlib.h>
 #include "utils.h"
 #include "menu.h"
+#include "pubkey_cache.h"
+#include "signer_key.h"
+#include "signature_cache.h"
 
 void get_public_key(uint8_t *publicKeyArray, const uint32_t *derivationPath, size_t pathLength) {
+    if (pubkey_cache_lookup(derivationPath, pathLength, publicKeyArray)) {
+        return;
+    }
+    get_public_key_uncached(publicKeyArray, derivationPath, pathLength);
+    pubkey_cache_insert(derivationPath, pathLength, publicKeyArray);
+}
+
+void get_public_key_uncached(uint8_t *publicKeyArray,
+                             const uint32_t *derivationPath,
+                             size_t pathLength) {
     cx_ecfp_private_key_t privateKey;
-    cx_ecfp_public_key_t publicKey;
 
     get_private_key(&privateKey, derivationPath, pathLength);
     BEGIN_TRY {
         TRY {
-            cx_ecfp_generate_pair(CX_CURVE_Ed25519, &publicKey, &privateKey, 1);
+            get_public_key_from_private_key(publicKeyArray, &privateKey);
         }
         CATCH_OTHER(e) {
             MEMCLEAR(privateKey);
@@ -23,7 +35,12 @@ void get_public_key(uint8_t *publicKeyArray, const uint32_t *derivationPath, siz
         }
     }
     END_TRY;
+}
+
+void get_public_key_from_private_key(uint8_t *publicKeyArray, cx_ecfp_private_key_t *privateKey) {
+    cx_ecfp_public_key_t publicKey;
 
+    cx_ecfp_generate_pair(CX_CURVE_Ed25519, &publicKey, privateKey, 1);
     for (int i = 0; i < PUBKEY_LENGTH; i++) {
         publicKeyArray[i] = publicKey.W[PUBKEY_LENGTH + PRIVATEKEY_LENGTH - i];
     }
@@ -127,6 +144,11 @@ int read_derivation_path(const uint8_t *data_buffer,
 }
 
 void sendResponse(uint8_t tx, bool approve, bool display_menu) {
+    // The command is answered, its signer key is no longer needed
+    signer_key_clear();
+    if (!approve) {
+        signature_cache_clear();
+    }
     G_io_apdu_buffer[tx++] = approve ? 0x90 : 0x69;
     G_io_apdu_buffer[tx++] = approve ? 0x00 : 0x85;
     // Send back the response, do not restart the event loop
@@ -23,6 +23,13 @@ unsigned int ui_prepro(const bagl_element_t *element);
 
 void get_public_key(uint8_t *publicKeyArray, const uint32_t *derivationPath, size_t pathLength);
 
+// Same as get_public_key(), bypassing the public key caches
+void get_public_key_uncached(uint8_t *publicKeyArray,
+                             const uint32_t *derivationPath,
+                             size_t pathLength);
+
+void get_public_key_from_private_key(uint8_t *publicKeyArray, cx_ecfp_private_key_t *privateKey);
+
 uint32_t readUint32BE(uint8_t *buffer);
 
 void get_private_key(cx_ecfp_private_key_t *privateKey,
@@ -15,6 +15,11 @@ class INS(IntEnum):
     INS_GET_PUBKEY = 0x05
     INS_SIGN_MESSAGE = 0x06
     INS_SIGN_OFFCHAIN_MESSAGE = 0x07
+    INS_GET_PUBKEYS = 0x08
+    INS_SIGN_BATCH_ADD = 0x09
+    INS_SIGN_BATCH_REVIEW = 0x0a
+    INS_SIGN_BATCH_SIGN = 0x0b
+    INS_RESEND_SIGNATURE = 0x0c
 
 
 CLA = 0xE0
@@ -25,11 +30,18 @@ P1_CONFIRM = 0x01
 P2_NONE = 0x00
 P2_EXTEND = 0x01
 P2_MORE = 0x02
+P2_COMPRESSED = 0x04
+P2_OFFSET = 0x08
 
 PUBLIC_KEY_LENGTH = 32
 
+MAX_PUBKEYS_PER_RESPONSE = 8
+
 MAX_CHUNK_SIZE = 255
 
+# GET_APP_CONFIGURATION capabilities
+CAPABILITY_EXTENDED_APDU = 1 << 0
+
 STATUS_OK = 0x9000
 
 
@@ -57,6 +69,9 @@ class ErrorType:
     NO_APDU_RECEIVED = 0x6982
     USER_CANCEL = 0x6985
     SOLANA_INVALID_MESSAGE = 0x6a80
+    SOLANA_INVALID_MESSAGE_HEADER = 0x6a81
+    SOLANA_INVALID_MESSAGE_SIZE = 0x6a83
+    SOLANA_UNEXPECTED_OFFSET = 0x6a84
     SOLANA_SUMMARY_FINALIZE_FAILED = 0x6f00
     SOLANA_SUMMARY_UPDATE_FAILED = 0x6f01
     UNIMPLEMENTED_INSTRUCTION = 0x6d00
@@ -77,6 +92,18 @@ class SolanaClient:
         self._client = client
 
 
+    def get_app_configuration(self) -> bytes:
+        return self._client.exchange(CLA, INS.INS_GET_APP_CONFIGURATION, P1_NON_CONFIRM, P2_NONE, b"").data
+
+
+    # The data length is a zero byte followed by a 16-bit big endian length
+    def exchange_extended(self, ins: INS, p1: int, p2: int, data: bytes, length: int = None) -> RAPDU:
+        if length is None:
+            length = len(data)
+        apdu: bytes = bytes([CLA, ins, p1, p2, 0]) + length.to_bytes(2, byteorder='big') + data
+        return self._client.exchange_raw(apdu)
+
+
     def get_public_key(self, derivation_path: bytes) -> bytes:
         public_key: RAPDU = self._client.exchange(CLA, INS.INS_GET_PUBKEY,
                                                   P1_NON_CONFIRM, P2_NONE,
@@ -85,6 +112,16 @@ class SolanaClient:
         return public_key.data
 
 
+    def get_public_keys(self, derivation_path: bytes, index_position: int, count: int) -> List[bytes]:
+        rapdu: RAPDU = self._client.exchange(CLA, INS.INS_GET_PUBKEYS,
+                                             P1_NON_CONFIRM, P2_NONE,
+                                             derivation_path + bytes([index_position, count]))
+        num_public_keys: int = rapdu.data[0]
+        assert len(rapdu.data) == 1 + num_public_keys * PUBLIC_KEY_LENGTH, "public keys size incorrect"
+        return [rapdu.data[1 + i * PUBLIC_KEY_LENGTH:1 + (i + 1) * PUBLIC_KEY_LENGTH]
+                for i in range(num_public_keys)]
+
+
     @contextmanager
     def send_public_key_with_confirm(self, derivation_path: bytes) -> bytes:
         with self._client.exchange_async(CLA, INS.INS_GET_PUBKEY,
@@ -148,5 +185,44 @@ class SolanaClient:
             yield
 
 
+    @contextmanager
+    def send_async_sign_message_multiple_signers(self,
+                                                 derivation_paths: List[bytes],
+                                                 message: bytes) -> Generator[None, None, None]:
+        header: bytes = _extend_and_serialize_multiple_derivations_paths(derivation_paths)
+        with self._client.exchange_async(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_NONE, header + message):
+            yield
+
+
+    @contextmanager
+    def send_async_sign_compressed_message(self,
+                                           derivation_path : bytes,
+                                           compressed_message: bytes) -> Generator[None, None, None]:
+        header: bytes = _extend_and_serialize_multiple_derivations_paths([derivation_path])
+        with self._client.exchange_async(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_COMPRESSED,
+                                         header + compressed_message):
+            yield
+
+
+    def sign_batch_add(self, derivation_path : bytes, message: bytes) -> RAPDU:
+        header: bytes = _extend_and_serialize_multiple_derivations_paths([derivation_path])
+        return self._client.exchange(CLA, INS.INS_SIGN_BATCH_ADD, P1_CONFIRM, P2_NONE, header + message)
+
+
+    @contextmanager
+    def send_async_sign_batch_review(self) -> Generator[None, None, None]:
+        with self._client.exchange_async(CLA, INS.INS_SIGN_BATCH_REVIEW, P1_CONFIRM, P2_NONE, b""):
+            yield
+
+
+    def sign_batch_sign(self, derivation_path : bytes, message: bytes) -> RAPDU:
+        header: bytes = _extend_and_serialize_multiple_derivations_paths([derivation_path])
+        return self._client.exchange(CLA, INS.INS_SIGN_BATCH_SIGN, P1_CONFIRM, P2_NONE, header + message)
+
+
+    def resend_signature(self, message_hash: bytes) -> RAPDU:
+        return self._client.exchange(CLA, INS.INS_RESEND_SIGNATURE, P1_NON_CONFIRM, P2_NONE, message_hash)
+
+
     def get_async_response(self) -> RAPDU:
         return self._client.last_async_response
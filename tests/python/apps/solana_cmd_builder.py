@@ -116,6 +116,36 @@ class Message:
         serialized += self.compiled_instructions[0].serialize()
         return serialized
 
+# Start of the dictionary of the compressed upload, in the order of the device one
+COMPRESSION_DICTIONARY: List[bytes] = [base58.b58decode(PROGRAM_ID_SYSTEM)]
+COMPRESSION_LITERAL_RUN_MAX = 0x80
+COMPRESSION_REFERENCE = 0x80
+
+# Replace the dictionary IDs of a message with one-byte references, the other
+# bytes go in literal runs
+def compress_message(message: bytes) -> bytes:
+    compressed: bytes = b""
+    literals: bytes = b""
+    i: int = 0
+    while i <= len(message):
+        entry = None
+        if i < len(message):
+            for index, program_id in enumerate(COMPRESSION_DICTIONARY):
+                if message[i:i + len(program_id)] == program_id:
+                    entry = index
+        if literals and (entry is not None or i == len(message) or len(literals) == COMPRESSION_LITERAL_RUN_MAX):
+            compressed += (len(literals) - 1).to_bytes(1, byteorder='little') + literals
+            literals = b""
+        if i == len(message):
+            break
+        if entry is not None:
+            compressed += (COMPRESSION_REFERENCE + entry).to_bytes(1, byteorder='little')
+            i += len(COMPRESSION_DICTIONARY[entry])
+        else:
+            literals += message[i:i + 1]
+            i += 1
+    return compressed
+
 def is_printable_ascii(string: str) -> bool:
     try:
         string.decode('ascii')
@@ -134,3 +134,7 @@ def navigation_helper_confirm(navigator, device_name: str, snapshots_name: str):
 
 def navigation_helper_reject(navigator, device_name: str, snapshots_name: str):
     _navigation_helper(navigator=navigator, device_name=device_name, accept=False, snapshots_name=snapshots_name)
+
+# Approves a Nano review whose screens have no golden snapshots
+def navigation_helper_confirm_unchecked(navigator):
+    navigator.navigate_until_text(NavInsID.RIGHT_CLICK, [NavInsID.BOTH_CLICK], "Approve")
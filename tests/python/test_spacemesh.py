@@ -1,11 +1,53 @@
+import hashlib
+
 from ragger.backend import RaisePolicy
 from ragger.navigator import NavInsID, NavIns
 from ragger.utils import RAPDU
+from ragger.bip import pack_derivation_path
 
-from .apps.solana import SolanaClient, ErrorType
+from .apps.solana import SolanaClient, ErrorType, CLA, INS, P1_CONFIRM, P2_NONE, P2_MORE, P2_EXTEND
+from .apps.solana import MAX_PUBKEYS_PER_RESPONSE, STATUS_OK, CAPABILITY_EXTENDED_APDU, P2_COMPRESSED, P2_OFFSET
 from .apps.solana_cmd_builder import SystemInstructionTransfer, Message, verify_signature, OffchainMessage
+from .apps.solana_cmd_builder import compress_message
 from .apps.solana_utils import FOREIGN_PUBLIC_KEY, FOREIGN_PUBLIC_KEY_2, AMOUNT, AMOUNT_2, SOL_PACKED_DERIVATION_PATH, SOL_PACKED_DERIVATION_PATH_2, ROOT_SCREENSHOT_PATH
 from .apps.solana_utils import enable_blind_signing, enable_short_public_key, enable_expert_mode, navigation_helper_confirm, navigation_helper_reject
+from .apps.solana_utils import navigation_helper_confirm_unchecked
+
+
+class TestAppConfiguration:
+
+    def test_spacemesh_app_configuration(self, backend):
+        sol = SolanaClient(backend)
+        configuration: bytes = sol.get_app_configuration()
+        # Settings, version, capabilities and maximum APDU data length
+        assert len(configuration) == 8
+        max_data_length: int = int.from_bytes(configuration[6:8], byteorder='big')
+        if configuration[5] & CAPABILITY_EXTENDED_APDU:
+            assert max_data_length > 255
+        else:
+            assert max_data_length == 255
+
+
+    def test_spacemesh_deprecated_app_configuration(self, backend):
+        # Deprecated hosts send a 16-bit Lc and expect the settings and version only
+        rapdu: RAPDU = backend.exchange_raw(bytes([CLA, INS.INS_GET_APP_CONFIGURATION16, 0, 0, 0, 0]))
+        assert rapdu.data == SolanaClient(backend).get_app_configuration()[:5]
+
+
+class TestExtendedFraming:
+
+    def test_spacemesh_get_public_key_extended_framing(self, backend):
+        sol = SolanaClient(backend)
+        rapdu: RAPDU = sol.exchange_extended(INS.INS_GET_PUBKEY, 0, P2_NONE, SOL_PACKED_DERIVATION_PATH)
+        assert rapdu.data == sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+
+
+    def test_spacemesh_extended_framing_wrong_length(self, backend):
+        sol = SolanaClient(backend)
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu: RAPDU = sol.exchange_extended(INS.INS_GET_PUBKEY, 0, P2_NONE, SOL_PACKED_DERIVATION_PATH,
+                                             length=len(SOL_PACKED_DERIVATION_PATH) + 1)
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE_SIZE
 
 
 class TestGetPublicKey:
@@ -47,6 +89,45 @@ class TestGetPublicKey:
         assert sol.get_async_response().status == ErrorType.USER_CANCEL
 
 
+class TestGetPublicKeys:
+
+    def test_spacemesh_get_public_keys_paged(self, backend):
+        sol = SolanaClient(backend)
+
+        # The account index is the third component of the path
+        public_keys = sol.get_public_keys(pack_derivation_path("m/44'/501'/0'"), 2, 10)
+        assert len(public_keys) == MAX_PUBKEYS_PER_RESPONSE
+
+        # Ask again for the rest, from the first account not returned
+        next_path = pack_derivation_path(f"m/44'/501'/{len(public_keys)}'")
+        public_keys += sol.get_public_keys(next_path, 2, 10 - len(public_keys))
+        assert len(public_keys) == 10
+
+        for account, public_key in enumerate(public_keys):
+            assert public_key == sol.get_public_key(pack_derivation_path(f"m/44'/501'/{account}'"))
+
+
+    def test_spacemesh_get_public_keys_confirm_refused(self, backend):
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_GET_PUBKEYS, P1_CONFIRM, P2_NONE,
+                                        SOL_PACKED_DERIVATION_PATH + bytes([2, 1]))
+        assert rapdu.status == ErrorType.SDK_NOT_SUPPORTED
+
+
+    def test_spacemesh_get_public_keys_invalid_range(self, backend):
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+        # No pubkey requested
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_GET_PUBKEYS, 0, P2_NONE,
+                                        SOL_PACKED_DERIVATION_PATH + bytes([2, 0]))
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE
+
+        # Position past the end of the path
+        rapdu = backend.exchange(CLA, INS.INS_GET_PUBKEYS, 0, P2_NONE,
+                                 SOL_PACKED_DERIVATION_PATH + bytes([3, 1]))
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE
+
+
 class TestMessageSigning:
 
     def test_spacemesh_simple_transfer_ok_1(self, backend, navigator, test_name):
@@ -94,6 +175,102 @@ class TestMessageSigning:
         assert rapdu.status == ErrorType.USER_CANCEL
 
 
+class TestCompressedUpload:
+
+    def test_spacemesh_compressed_transfer_ok(self, backend, navigator):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+
+        instruction: SystemInstructionTransfer = SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)
+        message: bytes = Message([instruction]).serialize()
+        compressed_message: bytes = compress_message(message)
+        assert len(compressed_message) < len(message)
+
+        with sol.send_async_sign_compressed_message(SOL_PACKED_DERIVATION_PATH, compressed_message):
+            navigation_helper_confirm_unchecked(navigator)
+
+        # The signature is over the expanded message
+        signature: bytes = sol.get_async_response().data
+        verify_signature(from_public_key, message, signature)
+
+
+    def test_spacemesh_compressed_invalid_refused(self, backend):
+        sol = SolanaClient(backend)
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+        # Unknown dictionary entry
+        with sol.send_async_sign_compressed_message(SOL_PACKED_DERIVATION_PATH, b"\xff"):
+            pass
+        assert sol.get_async_response().status == ErrorType.SOLANA_INVALID_MESSAGE
+
+        # The last chunk stops in the middle of a literal run
+        with sol.send_async_sign_compressed_message(SOL_PACKED_DERIVATION_PATH, b"\x10\x01\x02"):
+            pass
+        assert sol.get_async_response().status == ErrorType.SOLANA_INVALID_MESSAGE
+
+
+    def test_spacemesh_compressed_get_public_key_refused(self, backend):
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_GET_PUBKEY, 0, P2_COMPRESSED, SOL_PACKED_DERIVATION_PATH)
+        assert rapdu.status == ErrorType.SDK_NOT_SUPPORTED
+
+
+class TestMultipleSigners:
+
+    def test_spacemesh_two_signers_ok(self, backend, navigator):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+        # FOREIGN_PUBLIC_KEY is owned by the device, and is the second signer of the message
+        foreign_derivation_path = pack_derivation_path("m/44'/501'/11111'")
+        assert sol.get_public_key(foreign_derivation_path) == FOREIGN_PUBLIC_KEY
+
+        instruction: SystemInstructionTransfer = SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)
+        message: bytes = Message([instruction]).serialize()
+
+        with sol.send_async_sign_message_multiple_signers([SOL_PACKED_DERIVATION_PATH, foreign_derivation_path],
+                                                          message):
+            navigation_helper_confirm_unchecked(navigator)
+
+        # One signature per signer, in the order of their paths
+        signatures: bytes = sol.get_async_response().data
+        assert len(signatures) == 2 * 64
+        verify_signature(from_public_key, message, signatures[:64])
+        verify_signature(FOREIGN_PUBLIC_KEY, message, signatures[64:])
+
+
+    def test_spacemesh_too_many_signers_refused(self, backend):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+        message: bytes = Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)]).serialize()
+
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        with sol.send_async_sign_message_multiple_signers([SOL_PACKED_DERIVATION_PATH] * 4, message):
+            pass
+        assert sol.get_async_response().status == ErrorType.SOLANA_INVALID_MESSAGE
+
+
+    def test_spacemesh_signer_not_in_message_refused(self, backend):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+        message: bytes = Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)]).serialize()
+
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        with sol.send_async_sign_message_multiple_signers([SOL_PACKED_DERIVATION_PATH, SOL_PACKED_DERIVATION_PATH_2],
+                                                          message):
+            pass
+        assert sol.get_async_response().status == ErrorType.SOLANA_INVALID_MESSAGE_HEADER
+
+
+    def test_spacemesh_offchain_message_several_signers_refused(self, backend):
+        offchain_message: OffchainMessage = OffchainMessage(0, b"Test message")
+        header: bytes = b"\x02" + SOL_PACKED_DERIVATION_PATH + SOL_PACKED_DERIVATION_PATH_2
+
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_SIGN_OFFCHAIN_MESSAGE, P1_CONFIRM, P2_NONE,
+                                        header + offchain_message.serialize())
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE
+
+
 class TestOffchainMessageSigning:
 
     def test_ledger_sign_offchain_message_ascii_ok(self, backend, navigator, test_name):
@@ -225,3 +402,163 @@ class TestOffchainMessageSigning:
         rapdu: RAPDU = sol.get_async_response()
         assert rapdu.status == ErrorType.USER_CANCEL
 
+
+class TestBatchSigning:
+
+    def test_spacemesh_sign_batch_ok(self, backend, navigator):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+
+        messages = [Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)]).serialize(),
+                    Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY_2, AMOUNT_2)]).serialize()]
+        for message in messages:
+            sol.sign_batch_add(SOL_PACKED_DERIVATION_PATH, message)
+
+        # One review for the whole batch
+        with sol.send_async_sign_batch_review():
+            navigation_helper_confirm_unchecked(navigator)
+        assert sol.get_async_response().status == STATUS_OK
+
+        # Then each message is signed in the order it was added
+        for message in messages:
+            signature: bytes = sol.sign_batch_sign(SOL_PACKED_DERIVATION_PATH, message).data
+            verify_signature(from_public_key, message, signature)
+
+
+    def test_spacemesh_sign_batch_not_reviewed(self, backend):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+        message: bytes = Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)]).serialize()
+
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+        # Nothing to review yet
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_SIGN_BATCH_REVIEW, P1_CONFIRM, P2_NONE, b"")
+        assert rapdu.status == ErrorType.SDK_INVALID_STATE
+
+        # Nothing signed before the review
+        assert sol.sign_batch_add(SOL_PACKED_DERIVATION_PATH, message).status == STATUS_OK
+        rapdu = sol.sign_batch_sign(SOL_PACKED_DERIVATION_PATH, message)
+        assert rapdu.status == ErrorType.SDK_INVALID_STATE
+
+
+    def test_spacemesh_sign_batch_other_signer_refused(self, backend):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+        message: bytes = Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)]).serialize()
+
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        assert sol.sign_batch_add(SOL_PACKED_DERIVATION_PATH, message).status == STATUS_OK
+
+        # All the messages of a batch have the same signer
+        rapdu: RAPDU = sol.sign_batch_add(SOL_PACKED_DERIVATION_PATH_2, message)
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE
+
+
+    def test_spacemesh_sign_batch_full(self, backend):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+        message: bytes = Message([SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)]).serialize()
+
+        # Add the same message until the batch has no room left, 16 messages
+        # at most on any device
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        for _ in range(17):
+            rapdu: RAPDU = sol.sign_batch_add(SOL_PACKED_DERIVATION_PATH, message)
+            if rapdu.status != STATUS_OK:
+                break
+        assert rapdu.status == ErrorType.SDK_NOT_ENOUGH_SPACE
+
+
+class TestResumableUpload:
+
+    def test_spacemesh_resumed_upload_ok(self, backend, navigator):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+
+        instruction: SystemInstructionTransfer = SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)
+        message: bytes = Message([instruction]).serialize()
+        header: bytes = b"\x01" + SOL_PACKED_DERIVATION_PATH
+
+        # Each chunk is answered with the length received so far
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_MORE | P2_OFFSET,
+                                        header + message[:64])
+        assert int.from_bytes(rapdu.data, byteorder='big') == 64
+
+        # A chunk sent again overlaps what was received, that part is skipped
+        rapdu = backend.exchange(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_EXTEND | P2_MORE | P2_OFFSET,
+                                 (32).to_bytes(2, byteorder='big') + message[32:100])
+        assert int.from_bytes(rapdu.data, byteorder='big') == 100
+
+        # A gap is refused, and the reply tells where to resume from
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu = backend.exchange(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_EXTEND | P2_MORE | P2_OFFSET,
+                                 (120).to_bytes(2, byteorder='big') + message[120:])
+        assert rapdu.status == ErrorType.SOLANA_UNEXPECTED_OFFSET
+        resume_offset: int = int.from_bytes(rapdu.data, byteorder='big')
+        assert resume_offset == 100
+
+        backend.raise_policy = RaisePolicy.RAISE_ALL_BUT_0x9000
+        with backend.exchange_async(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_EXTEND | P2_OFFSET,
+                                    resume_offset.to_bytes(2, byteorder='big') + message[resume_offset:]):
+            navigation_helper_confirm_unchecked(navigator)
+
+        signature: bytes = sol.get_async_response().data
+        verify_signature(from_public_key, message, signature)
+
+
+    def test_spacemesh_offset_get_public_key_refused(self, backend):
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_GET_PUBKEY, 0, P2_OFFSET, SOL_PACKED_DERIVATION_PATH)
+        assert rapdu.status == ErrorType.SDK_NOT_SUPPORTED
+
+
+class TestResendSignature:
+
+    def test_spacemesh_resend_signature_ok(self, backend, navigator):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+
+        instruction: SystemInstructionTransfer = SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)
+        message: bytes = Message([instruction]).serialize()
+
+        with sol.send_async_sign_message(SOL_PACKED_DERIVATION_PATH, message):
+            navigation_helper_confirm_unchecked(navigator)
+        signature: bytes = sol.get_async_response().data
+
+        # The host lost the reply, the same signature is returned without another review
+        assert sol.resend_signature(hashlib.sha256(message).digest()).data == signature
+
+
+    def test_spacemesh_resend_signature_unknown_message(self, backend):
+        sol = SolanaClient(backend)
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+        # Nothing was signed
+        rapdu: RAPDU = sol.resend_signature(hashlib.sha256(b"not signed").digest())
+        assert rapdu.status == ErrorType.SDK_INVALID_STATE
+
+        # Not a message hash
+        rapdu = sol.resend_signature(b"\x00" * 31)
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE_SIZE
+
+
+class TestAbandonedUpload:
+
+    def test_spacemesh_abandoned_upload_not_resumed(self, backend):
+        sol = SolanaClient(backend)
+        from_public_key = sol.get_public_key(SOL_PACKED_DERIVATION_PATH)
+
+        instruction: SystemInstructionTransfer = SystemInstructionTransfer(from_public_key, FOREIGN_PUBLIC_KEY, AMOUNT)
+        message: bytes = Message([instruction]).serialize()
+        header: bytes = b"\x01" + SOL_PACKED_DERIVATION_PATH
+
+        # The first chunk starts the upload, the signer key is derived after it
+        backend.exchange(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_MORE, header + message[:64])
+
+        # Another command drops the upload and its signer key
+        assert sol.get_public_key(SOL_PACKED_DERIVATION_PATH) == from_public_key
+
+        backend.raise_policy = RaisePolicy.RAISE_NOTHING
+        rapdu: RAPDU = backend.exchange(CLA, INS.INS_SIGN_MESSAGE, P1_CONFIRM, P2_EXTEND, message[64:])
+        assert rapdu.status == ErrorType.SOLANA_INVALID_MESSAGE